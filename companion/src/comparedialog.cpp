@@ -3,6 +3,7 @@
 #include "helpers.h"
 #include "helpers_html.h"
 #include "eeprominterface.h"
+#include "modeldiff.h"
 #include <QtGui>
 #include <QImage>
 #include <QColor>
@@ -75,19 +76,34 @@ void CompareDialog::dragLeaveEvent(QDragLeaveEvent *event)
 
 void CompareDialog::printDiff()
 {
+  // only the sections which differ are rendered
+  ModelDiff diff(*g_model1, *g_model2);
+
   te->clear();
+  if (diff.isEmpty()) {
+    te->append("<h2>"+tr("The models are identical")+"</h2>");
+    return;
+  }
   printSetup();
-  if (GetCurrentFirmware()->getCapability(FlightModes)) {
+  if (GetCurrentFirmware()->getCapability(FlightModes) && (diff.hasChanges(MODEL_DIFF_FLIGHT_MODES) || diff.hasChanges(MODEL_DIFF_GVARS))) {
     printPhases();
   }
-  printExpos();
-  printMixers();
-  printLimits();
-  printCurves();
-  printGvars();
-  printSwitches();
-  printFSwitches();
-  printFrSky();
+  if (diff.hasChanges(MODEL_DIFF_INPUTS))
+    printExpos();
+  if (diff.hasChanges(MODEL_DIFF_MIXES))
+    printMixers();
+  if (diff.hasChanges(MODEL_DIFF_LIMITS))
+    printLimits();
+  if (diff.hasChanges(MODEL_DIFF_CURVES))
+    printCurves();
+  if (diff.hasChanges(MODEL_DIFF_FLIGHT_MODES) || diff.hasChanges(MODEL_DIFF_GVARS))
+    printGvars();
+  if (diff.hasChanges(MODEL_DIFF_LOGICAL_SWITCHES))
+    printSwitches();
+  if (diff.hasChanges(MODEL_DIFF_CUSTOM_FUNCTIONS))
+    printFSwitches();
+  if (diff.hasChanges(MODEL_DIFF_TELEMETRY))
+    printFrSky();
   te->scrollToAnchor("1");
 }
 
@@ -19,65 +19,116 @@
 
 #define DIM(arr) (sizeof((arr))/sizeof((arr)[0]))
 
-class DataField {
+/*
+ * Fields are serialized LSB first, one after the other, without any
+ * alignment. BitWriter and BitReader move up to 8 bits at a time
+ * between the fields and the byte buffer.
+ */
+class BitWriter {
   public:
-    DataField(const char *name=""):
-      name(name)
+    BitWriter(QByteArray & buffer):
+      buffer(buffer),
+      offset(0)
     {
+      buffer.clear();
     }
-    virtual const char *getName() { return name; }
-    virtual ~DataField() { }
-    virtual void ExportBits(QBitArray & output) = 0;
-    virtual void ImportBits(QBitArray & input) = 0;
-    virtual unsigned int size() = 0;
 
-    QBitArray bytesToBits(QByteArray bytes)
+    void write(unsigned int value, unsigned int bits)
     {
-      QBitArray bits(bytes.count()*8);
-      // Convert from QByteArray to QBitArray
-      for (int i=0; i<bytes.count(); ++i)
-        for (int b=0; b<8; ++b)
-          bits.setBit(i*8+b, bytes.at(i)&(1<<b));
-      return bits;
+      while (bits) {
+        unsigned int byte = offset / 8;
+        unsigned int shift = offset % 8;
+        unsigned int count = qMin(bits, 8-shift);
+        if (byte == (unsigned int)buffer.size())
+          buffer.append('\0');
+        buffer[byte] = buffer.at(byte) | ((value & ((1<<count)-1)) << shift);
+        value >>= count;
+        bits -= count;
+        offset += count;
+      }
     }
 
-    QByteArray bitsToBytes(QBitArray bits, int offset=0)
+    unsigned int position() const
     {
-      QByteArray bytes;
-      bytes.resize((offset+bits.count()+7)/8);
-      bytes.fill(0);
-      // Convert from QBitArray to QByteArray
-      for (int b=0; b<bits.count(); ++b)
-        bytes[(b+offset)/8] = ( bytes.at((b+offset)/8) | ((bits[b]?1:0)<<((b+offset)%8)));
-      return bytes;
+      return offset;
     }
 
+  protected:
+    QByteArray & buffer;
+    unsigned int offset;
+};
+
+class BitReader {
+  public:
+    BitReader(const QByteArray & buffer, unsigned int offset=0):
+      data((const uint8_t *)buffer.constData()),
+      length(buffer.size()),
+      offset(offset)
+    {
+    }
+
+    unsigned int read(unsigned int bits)
+    {
+      unsigned int result = 0;
+      unsigned int done = 0;
+      while (done < bits && done < 32) {
+        unsigned int byte = offset / 8;
+        unsigned int shift = offset % 8;
+        unsigned int count = qMin(bits-done, 8-shift);
+        unsigned int value = (byte < length ? data[byte] : 0);
+        result |= ((value >> shift) & ((1u<<count)-1)) << done;
+        done += count;
+        offset += count;
+      }
+      // the bits above 32 (spare fields) are skipped
+      offset += bits - done;
+      return result;
+    }
+
+  protected:
+    const uint8_t * data;
+    unsigned int length;
+    unsigned int offset;
+};
+
+class DataField {
+  public:
+    DataField(const char *name=""):
+      name(name)
+    {
+    }
+    virtual const char *getName() { return name; }
+    virtual ~DataField() { }
+    virtual void ExportBits(BitWriter & output) = 0;
+    virtual void ImportBits(BitReader & input) = 0;
+    virtual unsigned int size() = 0;
+
     int Export(QByteArray & output)
     {
-      QBitArray result;
-      ExportBits(result);
-      output = bitsToBytes(result);
+      BitWriter writer(output);
+      ExportBits(writer);
       return 0;
     }
 
     int Import(QByteArray & input)
     {
-      QBitArray bits = bytesToBits(input);
-      ImportBits(bits);
+      BitReader reader(input);
+      ImportBits(reader);
       return 0;
     }
 
     virtual int Dump(int level=0, int offset=0)
     {
-      QBitArray bits;
-      ExportBits(bits);
-      QByteArray bytes = bitsToBytes(bits);
-      int result = (offset+bits.count()) % 8;
+      QByteArray bytes;
+      BitWriter writer(bytes);
+      ExportBits(writer);
+      int bits = writer.position();
+      int result = (offset+bits) % 8;
       for (int i=0; i<level; i++) printf("  ");
-      if (bits.count() % 8 == 0)
+      if (bits % 8 == 0)
         printf("%s (%dbytes) ", getName(), bytes.count());
       else
-        printf("%s (%dbits) ", getName(), bits.count());
+        printf("%s (%dbits) ", getName(), bits);
       for (int i=0; i<bytes.count(); i++) {
         unsigned char c = bytes[i];
         if ((i==0 && offset) || (i==bytes.count()-1 && result!=0))
@@ -131,26 +182,18 @@ class BaseUnsignedField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
       container value = field;
       if (value > max) value = max;
       if (value < min) value = min;
 
-      output.resize(N);
-      for (int i=0; i<N; i++) {
-        if (value & (1<<i))
-          output.setBit(i);
-      }
+      output.write(value, N);
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
-      field = 0;
-      for (int i=0; i<N; i++) {
-        if (input[i])
-          field |= (1<<i);
-      }
+      field = input.read(N);
     }
 
     virtual unsigned int size()
@@ -196,17 +239,14 @@ class BoolField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
-      output.resize(N);
-      if (field) {
-        output.setBit(0);
-      }
+      output.write(field ? 1 : 0, N);
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
-      field = input[0] ? true : false;
+      field = (input.read(N) & 1) ? true : false;
     }
 
     virtual unsigned int size()
@@ -248,31 +288,21 @@ class SignedField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
       int value = field;
       if (value > max) value = max;
       if (value < min) value = min;
 
-      output.resize(N);
-      for (int i=0; i<N; i++) {
-        if (((unsigned int)value) & (1<<i))
-          output.setBit(i);
-      }
+      output.write((unsigned int)value, N);
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
-      unsigned int value = 0;
-      for (int i=0; i<N; i++) {
-        if (input[i])
-          value |= (1<<i);
-      }
+      unsigned int value = input.read(N);
 
-      if (input[N-1]) {
-        for (unsigned int i=N; i<8*sizeof(int); i++) {
-          value |= (1<<i);
-        }
+      if (N < 8*sizeof(int) && (value & (1u<<(N-1)))) {
+        value |= ~0u << N;
       }
 
       field = (int)value;
@@ -311,30 +341,18 @@ class CharField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
-      output.resize(N*8);
-      int b = 0;
       int len = truncate ? strlen(field) : N;
       for (int i=0; i<N; i++) {
-        int idx = (i>=len ? 0 : field[i]);
-        for (int j=0; j<8; j++, b++) {
-          if (idx & (1<<j))
-            output.setBit(b);
-        }
+        output.write(i>=len ? 0 : (uint8_t)field[i], 8);
       }
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
-      unsigned int b = 0;
       for (int i=0; i<N; i++) {
-        int8_t idx = 0;
-        for (int j=0; j<8; j++) {
-          if (input[b++])
-            idx |= (1<<j);
-        }
-        field[i] = idx;
+        field[i] = (int8_t)input.read(8);
       }
     }
 
@@ -360,30 +378,18 @@ class ZCharField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
-      output.resize(N*8);
-      int b = 0;
       int len = strlen(field);
       for (int i=0; i<N; i++) {
-        int idx = i>=len ? 0 : char2idx(field[i]);
-        for (int j=0; j<8; j++, b++) {
-          if (idx & (1<<j))
-            output.setBit(b);
-        }
+        output.write(i>=len ? 0 : (uint8_t)char2idx(field[i]), 8);
       }
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
-      unsigned int b = 0;
       for (int i=0; i<N; i++) {
-        int8_t idx = 0;
-        for (int j=0; j<8; j++) {
-          if (input[b++])
-            idx |= (1<<j);
-        }
-        field[i] = idx2char(idx);
+        field[i] = idx2char((int8_t)input.read(8));
       }
 
       field[N] = '\0';
@@ -421,28 +427,17 @@ class StructField: public DataField {
       fields.append(field);
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
-      int offset = 0;
-      output.resize(size());
       foreach(DataField *field, fields) {
-        QBitArray bits;
-        field->ExportBits(bits);
-        for (int i=0; i<bits.size(); i++)
-          output[offset++] = bits[i];
+        field->ExportBits(output);
       }
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
-      int offset = 0;
       foreach(DataField *field, fields) {
-        unsigned int size = field->size();
-        QBitArray bits(size);
-        for (unsigned int i=0; i<size; i++) {
-          bits[i] = input[offset++];
-        }
-        field->ImportBits(bits);
+        field->ImportBits(input);
       }
     }
 
@@ -481,13 +476,13 @@ class TransformedField: public DataField {
     {
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
       beforeExport();
       field.ExportBits(output);
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
       field.ImportBits(input);
       afterImport();
@@ -525,8 +520,8 @@ class ConversionTable {
     {
       after = 0;
 
-      for (std::list<ConversionTuple>::iterator it=exportTable.begin(); it!=exportTable.end(); it++) {
-        ConversionTuple tuple = *it;
+      for (std::list<ConversionTuple>::const_iterator it=exportTable.begin(); it!=exportTable.end(); it++) {
+        const ConversionTuple & tuple = *it;
         if (before == tuple.a) {
           after = tuple.b;
           return true;
@@ -540,8 +535,8 @@ class ConversionTable {
     {
       after = 0;
 
-      for (std::list<ConversionTuple>::iterator it=importTable.begin(); it!=importTable.end(); it++) {
-        ConversionTuple tuple = *it;
+      for (std::list<ConversionTuple>::const_iterator it=importTable.begin(); it!=importTable.end(); it++) {
+        const ConversionTuple & tuple = *it;
         if (before == tuple.b) {
           after = tuple.a;
           return true;
@@ -1507,10 +1507,29 @@ void unregisterFirmwares()
   }
 }
 
-bool loadEEprom(RadioData &radioData, const uint8_t *eeprom, const int size)
+static bool loadEEprom(EEPROMInterface *eepromInterface, RadioData &radioData, const uint8_t *eeprom, const int size, QFuture<void> *decoding)
 {
+  if (decoding)
+    return eepromInterface->loadAsync(radioData, eeprom, size, *decoding);
+  else
+    return eepromInterface->load(radioData, eeprom, size);
+}
+
+// with decoding, the models may still be decoded when it returns, radioData must be kept until it is finished
+bool loadEEprom(RadioData &radioData, const uint8_t *eeprom, const int size, QFuture<void> *decoding)
+{
+  // only the interfaces which recognize the image are tried, trial parsing
+  // with all the others is the fallback
+  QList<EEPROMInterface *> others;
   foreach(EEPROMInterface *eepromInterface, eepromInterfaces) {
-    if (eepromInterface->load(radioData, eeprom, size))
+    if (!eepromInterface->probe(eeprom, size))
+      others.append(eepromInterface);
+    else if (loadEEprom(eepromInterface, radioData, eeprom, size, decoding))
+      return true;
+  }
+
+  foreach(EEPROMInterface *eepromInterface, others) {
+    if (loadEEprom(eepromInterface, radioData, eeprom, size, decoding))
       return true;
   }
 
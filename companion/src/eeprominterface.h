@@ -22,6 +22,7 @@
 #include <QString>
 #include <QStringList>
 #include <QList>
+#include <QFuture>
 #include <QtXml>
 #include <iostream>
 
@@ -1342,8 +1343,18 @@ class EEPROMInterface
 
     inline BoardEnum getBoard() { return board; }
 
+    // quick look at the size, file system and version markers, true when load() may succeed
+    virtual bool probe(const uint8_t *eeprom, int size) = 0;
+
     virtual bool load(RadioData &radioData, const uint8_t *eeprom, int size) = 0;
 
+    // like load(), the models may still be decoded by decoding when it returns
+    virtual bool loadAsync(RadioData &radioData, const uint8_t *eeprom, int size, QFuture<void> &decoding)
+    {
+      decoding = QFuture<void>();
+      return load(radioData, eeprom, size);
+    }
+
     virtual bool loadBackup(RadioData &radioData, uint8_t *eeprom, int esize, int index) = 0;
     
     virtual bool loadxml(RadioData &radioData, QDomDocument &doc) = 0;
@@ -1470,7 +1481,7 @@ void registerOpenTxFirmwares();
 void unregisterFirmwares();
 
 bool loadBackup(RadioData &radioData, uint8_t *eeprom, int esize, int index);
-bool loadEEprom(RadioData &radioData, const uint8_t *eeprom, int size);
+bool loadEEprom(RadioData &radioData, const uint8_t *eeprom, int size, QFuture<void> *decoding=NULL);
 bool loadEEpromXml(RadioData &radioData, QDomDocument &doc);
 
 struct Option {
@@ -20,6 +20,7 @@
 #include <string.h>
 #include <assert.h>
 #include <algorithm>
+#include <vector>
 #include "eeprominterface.h"
 #include "file.h"
 
@@ -293,11 +294,39 @@ unsigned int RleFile::readRlc12(uint8_t *buf, unsigned int i_len, bool rlc2)
   memset(buf, 0, i_len);
 
   if (IS_SKY9X(board)) {
+    unsigned int start = m_pos - sizeof(t_eeprom_header);
     int len = std::min((int)i_len, (int)m_size + (int)sizeof(t_eeprom_header) - (int)m_pos);
     if (len > 0) {
       eeprom_read_block(buf, (m_fileId << 12) + m_pos, len);
       m_pos += len;
     }
+    else {
+      len = 0;
+    }
+    // replay the changes the radio saved in the journal after the image,
+    // the end of a block which isn't flagged may hold anything
+    t_eeprom_header header;
+    eeprom_read_block(&header, m_fileId << 12, sizeof(header));
+    unsigned int pos = (header.flags & EE32_FLAG_JOURNAL) ? sizeof(t_eeprom_header) + m_size : 4096;
+    while (pos + sizeof(t_journal_record) <= 4096) {
+      t_journal_record record;
+      uint8_t data[256];
+      eeprom_read_block(&record, (m_fileId << 12) + pos, sizeof(record));
+      pos += sizeof(record);
+      if (record.size == 0 || record.offset == 0xFFFF || pos + record.size > 4096)
+        break;
+      eeprom_read_block(data, (m_fileId << 12) + pos, record.size);
+      if ((uint8_t)(byte_checksum((uint8_t *)&record, 3) + byte_checksum(data, record.size)) != record.csum)
+        break;
+      for (unsigned int i=0; i<record.size; i++) {
+        unsigned int ofs = record.offset + i;
+        if (ofs >= start && ofs < start + i_len) {
+          buf[ofs - start] = data[i];
+          len = std::max(len, (int)(ofs - start + 1));
+        }
+      }
+      pos += record.size;
+    }
     return len;
   }
   else {
@@ -512,10 +541,15 @@ unsigned int RleFile::writeRlc2(unsigned int i_fileId, unsigned int typ, const u
   if (IS_SKY9X(board)) {
     openRd(i_fileId);
     eeprom_write_block(buf, (m_fileId << 12) + m_pos, i_len);
+    // the end of the block is erased, it holds the journal of the changes saved by the radio
+    if (m_pos + i_len < 4096) {
+      std::vector<uint8_t> erased(4096 - m_pos - i_len, 0xFF);
+      eeprom_write_block(&erased[0], (m_fileId << 12) + m_pos + i_len, erased.size());
+    }
     t_eeprom_header header;
     header.sequence_no = 1;
     header.data_size = i_len;
-    header.flags = 0;
+    header.flags = EE32_FLAG_JOURNAL;
     header.hcsum = byte_checksum((uint8_t *) &header, 7);
     eeprom_write_block(&header, (m_fileId << 12), sizeof(header));
     return i_len;
@@ -61,6 +61,16 @@ struct t_eeprom_header
   uint8_t hcsum ;
 };
 
+// the end of the block holds a journal of the changes saved by the radio
+#define EE32_FLAG_JOURNAL 0x01
+
+struct t_journal_record
+{
+  uint16_t offset ;               // offset in the data area, 0xFFFF for the end of the journal
+  uint8_t size ;
+  uint8_t csum ;                  // sum of the offset, size and data bytes
+};
+
 class RleFile
 {
   uint8_t       m_fileId;    //index of file in directory = filename
@@ -24,6 +24,32 @@
 #define DATE_MARK   "DATE"
 #define TIME_MARK   "TIME"
 #define EEPR_MARK   "EEPR"
+#define LABEL_MARK  "\037\033:"
+#define LABEL_SIZE  4
+
+class Crc32Table {
+  public:
+    Crc32Table()
+    {
+      for (quint32 i=0; i<256; i++) {
+        quint32 crc = i;
+        for (int j=0; j<8; j++)
+          crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        values[i] = crc;
+      }
+    }
+    quint32 values[256];
+};
+
+static const Crc32Table crc32Table;
+
+quint32 crc32(const uint8_t *data, int size)
+{
+  quint32 crc = 0xFFFFFFFF;
+  for (int i=0; i<size; i++)
+    crc = crc32Table.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
 
 int getFileType(const QString &fullFileName)
 {
@@ -54,18 +80,27 @@ FirmwareInterface::FirmwareInterface(const QString &filename):
 {
   if (!filename.isEmpty()) {
     QFile file(filename);
-    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
-      QTextStream inputStream(&file);
-      flash_size = HexInterface(inputStream).load((uint8_t *)flash.data(), MAX_FSIZE);
-      file.close();
+    if (file.open(QIODevice::ReadOnly)) {
+      // the HEX text is parsed straight from the mapped file, a BIN is copied as is
+      QByteArray contents;
+      qint64 size = file.size();
+      const uint8_t *data = file.map(0, size);
+      if (!data) {
+        contents = file.read(MAX_FSIZE * 4);
+        data = (const uint8_t *)contents.constData();
+        size = contents.size();
+      }
+      flash_size = HexInterface::parse(data, size, (uint8_t *)flash.data(), MAX_FSIZE);
       if (flash_size == 0) {
-        file.open(QIODevice::ReadOnly);
-        flash_size = file.read((char *)flash.data(), MAX_FSIZE);
+        flash_size = qMin<qint64>(size, MAX_FSIZE);
+        memcpy(flash.data(), data, flash_size);
       }
+      file.close();
     }
   }
 
   if (flash_size > 0) {
+    indexLabels();
     version = seekLabel(VERS_MARK);
     if (version.startsWith("opentx-")) {
       int index = version.lastIndexOf('-');
@@ -92,14 +127,21 @@ FirmwareInterface::FirmwareInterface(const QString &filename):
 }
 
 QString FirmwareInterface::seekString(const QString & string)
+{
+  int start = seekPattern(string.toLatin1());
+  if (start > 0) {
+    return readString(start + string.length());
+  }
+  return "";
+}
+
+QString FirmwareInterface::readString(int start)
 {
   QString result = "";
 
-  int start = flash.indexOf(string);
   if (start > 0) {
-    start += string.length();
     int end = -1;
-    for (int i=start; i<start+50; i++) {
+    for (int i=start; i<start+50 && i<flash.size(); i++) {
       char c = flash.at(i);
       if (c == '\0' || c == '\036') {
         end = i;
@@ -114,11 +156,29 @@ QString FirmwareInterface::seekString(const QString & string)
   return result;
 }
 
+// the labels are found in one pass, instead of one search of the whole image per label
+void FirmwareInterface::indexLabels()
+{
+  static const QByteArrayMatcher matcher(QByteArray(LABEL_MARK));
+  labels.clear();
+  int index = matcher.indexIn(flash.constData(), flash_size, LABEL_SIZE);
+  while (index >= 0) {
+    QByteArray label = flash.mid(index - LABEL_SIZE, LABEL_SIZE);
+    if (!labels.contains(label)) {
+      labels.insert(label, index + matcher.pattern().size());
+    }
+    index = matcher.indexIn(flash.constData(), flash_size, index + 1);
+  }
+}
+
 QString FirmwareInterface::seekLabel(const QString & label)
 {
-  QString result = seekString(label + "\037\033:");
-  if (!result.isEmpty())
-    return result;
+  QHash<QByteArray, int>::const_iterator it = labels.constFind(label.toLatin1());
+  if (it != labels.constEnd()) {
+    QString result = readString(it.value());
+    if (!result.isEmpty())
+      return result;
+  }
 
   return seekString(label + ":");
 }
@@ -146,9 +206,15 @@ bool FirmwareInterface::isHardwareCompatible(const FirmwareInterface &previousFi
   return (newFlavour == previousFlavour);
 }
 
+// searches only the loaded part of the image, not the whole MAX_FSIZE buffer
+int FirmwareInterface::seekPattern(const QByteArray & pattern, int from)
+{
+  return QByteArrayMatcher(pattern).indexIn(flash.constData(), flash_size, from);
+}
+
 bool FirmwareInterface::SeekSplash(QByteArray splash)
 {
-  int start = flash.indexOf(splash);
+  int start = seekPattern(splash);
   if (start>0) {
     splash_offset = start;
     splash_size = splash.size();
@@ -161,12 +227,13 @@ bool FirmwareInterface::SeekSplash(QByteArray splash)
 
 bool FirmwareInterface::SeekSplash(QByteArray sps, QByteArray spe, int size)
 {
+  QByteArrayMatcher matcher(sps);
   int start = 0;
   while (start>=0) {
-    start = flash.indexOf(sps, start+1);
+    start = matcher.indexIn(flash.constData(), flash_size, start+1);
     if (start>0) {
       int end = start + sps.size() + size;
-      if (end == flash.indexOf(spe, end)) {
+      if (end == seekPattern(spe, end)) {
         splash_offset = start + sps.size();
         splash_size = end - start - sps.size();
         return true;
@@ -333,6 +400,11 @@ bool FirmwareInterface::isValid()
   return isValidFlag;
 }
 
+quint32 FirmwareInterface::getCrc()
+{
+  return crc32((const uint8_t *)flash.constData(), flash_size);
+}
+
 unsigned int FirmwareInterface::save(QString fileName)
 {
   uint8_t binflash[MAX_FSIZE];
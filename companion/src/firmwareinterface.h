@@ -18,6 +18,8 @@
 #include <QString>
 #include <QImage>
 #include <QByteArray>
+#include <QHash>
+#include <inttypes.h>
 
 #define MAX_FSIZE (512*1024)
 #define SPLASH_WIDTH (128)
@@ -38,6 +40,7 @@
 #define FILE_TYPE_XML  5
 
 int getFileType(const QString &fullFileName);
+quint32 crc32(const uint8_t *data, int size);
 
 class FirmwareInterface
 {
@@ -61,10 +64,15 @@ class FirmwareInterface
     QImage::Format getSplashFormat();
     unsigned int save(QString fileName);
     bool isValid();
+    quint32 getCrc();
 
   private:
     QByteArray flash;
     uint flash_size;
+    QHash<QByteArray, int> labels;
+    void indexLabels();
+    QString readString(int start);
+    int seekPattern(const QByteArray & pattern, int from=0);
     QString seekString(const QString & string);
     QString seekLabel(const QString & label);
     void SeekSplash();
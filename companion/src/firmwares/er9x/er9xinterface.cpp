@@ -114,6 +114,34 @@ bool Er9xInterface::loadxml(RadioData &radioData, QDomDocument &doc)
   return true;
 }
 
+static bool isEr9xVersion(uint8_t version)
+{
+  switch(version) {
+    case 3:
+      // old gruvin9x
+    case 4:
+//    case 5:
+    case 6:
+    case 7:
+    case 8:
+    case 9:
+    case 10:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool Er9xInterface::probe(const uint8_t *eeprom, int size)
+{
+  if (size != getEEpromSize() || !efile->EeFsOpen((uint8_t *)eeprom, size, BOARD_STOCK))
+    return false;
+
+  uint8_t version;
+  efile->openRd(FILE_GENERAL);
+  return efile->readRlc1(&version, 1) == 1 && isEr9xVersion(version);
+}
+
 bool Er9xInterface::load(RadioData &radioData, const uint8_t *eeprom, int size)
 {
   std::cout << "trying er9x import... ";
@@ -138,20 +166,12 @@ bool Er9xInterface::load(RadioData &radioData, const uint8_t *eeprom, int size)
 
   std::cout << "version " << (unsigned int)er9xGeneral.myVers << " ";
 
-  switch(er9xGeneral.myVers) {
-    case 3:
-      std::cout << "(old gruvin9x) ";
-    case 4:
-//    case 5:
-    case 6:
-    case 7:
-    case 8:
-    case 9:
-    case 10:
-      break;
-    default:
-      std::cout << "not er9x\n";
-      return false;
+  if (!isEr9xVersion(er9xGeneral.myVers)) {
+    std::cout << "not er9x\n";
+    return false;
+  }
+  else if (er9xGeneral.myVers == 3) {
+    std::cout << "(old gruvin9x) ";
   }
 
   efile->openRd(FILE_GENERAL);
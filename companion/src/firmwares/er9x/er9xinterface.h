@@ -34,6 +34,8 @@ class Er9xInterface : public EEPROMInterface
 
     virtual const int getMaxModels();
 
+    virtual bool probe(const uint8_t * eeprom, int size);
+
     virtual bool load(RadioData &, const uint8_t * eeprom, int size);
 
     virtual bool loadBackup(RadioData &, uint8_t * eeprom, int esize, int index);
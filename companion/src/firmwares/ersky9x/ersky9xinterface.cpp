@@ -151,6 +151,16 @@ bool Ersky9xInterface::loadxml(RadioData &radioData, QDomDocument &doc)
   return true;
 }
 
+bool Ersky9xInterface::probe(const uint8_t *eeprom, int size)
+{
+  if (size != EESIZE_SKY9X || !efile->EeFsOpen((uint8_t *)eeprom, size, BOARD_SKY9X))
+    return false;
+
+  uint8_t version;
+  efile->openRd(FILE_GENERAL);
+  return efile->readRlc2(&version, 1) == 1 && (version == 10 || version == 11);
+}
+
 bool Ersky9xInterface::load(RadioData &radioData, const uint8_t *eeprom, int size)
 {
   std::cout << "trying ersky9x import... ";
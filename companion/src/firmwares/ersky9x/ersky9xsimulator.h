@@ -34,6 +34,12 @@ class Ersky9xSimulator : public SimulatorInterface {
 
     virtual bool timer10ms();
 
+    virtual void setSpeed(unsigned int speed) { }
+
+    virtual void saveState(QByteArray & state) { }
+
+    virtual bool restoreState(const QByteArray & state) { return false; }
+
     virtual uint8_t * getLcd();
 
     virtual bool lcdChanged(bool & lightEnable);
@@ -99,6 +99,44 @@ bool Gruvin9xInterface::loadxml(RadioData &radioData, QDomDocument &doc)
 }
 
 
+static bool isGruvin9xVersion(uint8_t version)
+{
+  switch(version) {
+    case 5:
+    case 100:
+    case 101:
+    case 102:
+    case 103:
+    case 104:
+    case 105:
+      // subtrims(16bits) + function switches added
+    case 106:
+      // trims(10bits), no subtrims
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool Gruvin9xInterface::probe(const uint8_t *eeprom, int size)
+{
+  if (size != this->getEEpromSize() || !efile->EeFsOpen((uint8_t *)eeprom, size, BOARD_STOCK))
+    return false;
+
+  uint8_t version;
+  efile->openRd(FILE_GENERAL);
+  if (efile->readRlc2(&version, 1) != 1)
+    return false;
+
+  if (version == 0) {
+    efile->openRd(FILE_GENERAL);
+    if (efile->readRlc1(&version, 1) != 1)
+      return false;
+  }
+
+  return isGruvin9xVersion(version);
+}
+
 bool Gruvin9xInterface::load(RadioData &radioData, const uint8_t *eeprom, int size)
 {
   std::cout << "trying " << getName() << " import... ";
@@ -131,21 +169,9 @@ bool Gruvin9xInterface::load(RadioData &radioData, const uint8_t *eeprom, int si
 
   std::cout << "version " << (unsigned int)version << " ";
 
-  switch(version) {
-    case 5:
-    case 100:
-    case 101:
-    case 102:
-    case 103:
-    case 104:
-    case 105:
-      // subtrims(16bits) + function switches added
-    case 106:
-      // trims(10bits), no subtrims
-      break;
-    default:
-      std::cout << "not gruvin9x\n";
-      return false;
+  if (!isGruvin9xVersion(version)) {
+    std::cout << "not gruvin9x\n";
+    return false;
   }
 
   efile->openRd(FILE_GENERAL);
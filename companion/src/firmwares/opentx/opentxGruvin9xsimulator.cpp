@@ -153,6 +153,24 @@ bool Open9xGruvin9xSimulator::timer10ms()
 #include "simulatorimport.h"
 }
 
+void Open9xGruvin9xSimulator::setSpeed(unsigned int speed)
+{
+#define SETSPEED_IMPORT
+#include "simulatorimport.h"
+}
+
+void Open9xGruvin9xSimulator::saveState(QByteArray & state)
+{
+#define SAVESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
+bool Open9xGruvin9xSimulator::restoreState(const QByteArray & state)
+{
+#define RESTORESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
 uint8_t * Open9xGruvin9xSimulator::getLcd()
 {
 #define GETLCD_IMPORT
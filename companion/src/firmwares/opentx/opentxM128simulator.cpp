@@ -153,6 +153,24 @@ bool OpenTxM128Simulator::timer10ms()
 #include "simulatorimport.h"
 }
 
+void OpenTxM128Simulator::setSpeed(unsigned int speed)
+{
+#define SETSPEED_IMPORT
+#include "simulatorimport.h"
+}
+
+void OpenTxM128Simulator::saveState(QByteArray & state)
+{
+#define SAVESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
+bool OpenTxM128Simulator::restoreState(const QByteArray & state)
+{
+#define RESTORESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
 uint8_t * OpenTxM128Simulator::getLcd()
 {
 #define GETLCD_IMPORT
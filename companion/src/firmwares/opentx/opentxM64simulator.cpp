@@ -159,6 +159,24 @@ bool OpenTxM64Simulator::timer10ms()
 #include "simulatorimport.h"
 }
 
+void OpenTxM64Simulator::setSpeed(unsigned int speed)
+{
+#define SETSPEED_IMPORT
+#include "simulatorimport.h"
+}
+
+void OpenTxM64Simulator::saveState(QByteArray & state)
+{
+#define SAVESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
+bool OpenTxM64Simulator::restoreState(const QByteArray & state)
+{
+#define RESTORESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
 uint8_t * OpenTxM64Simulator::getLcd()
 {
 #define GETLCD_IMPORT
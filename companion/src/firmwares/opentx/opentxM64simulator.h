@@ -35,6 +35,12 @@ class OpenTxM64Simulator : public SimulatorInterface {
 
     virtual bool timer10ms();
 
+    virtual void setSpeed(unsigned int speed);
+
+    virtual void saveState(QByteArray & state);
+
+    virtual bool restoreState(const QByteArray & state);
+
     virtual uint8_t * getLcd();
 
     virtual bool lcdChanged(bool & lightEnable);
@@ -198,6 +198,24 @@ bool Open9xSky9xSimulator::timer10ms()
 #include "simulatorimport.h"
 }
 
+void Open9xSky9xSimulator::setSpeed(unsigned int speed)
+{
+#define SETSPEED_IMPORT
+#include "simulatorimport.h"
+}
+
+void Open9xSky9xSimulator::saveState(QByteArray & state)
+{
+#define SAVESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
+bool Open9xSky9xSimulator::restoreState(const QByteArray & state)
+{
+#define RESTORESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
 ::uint8_t * Open9xSky9xSimulator::getLcd()
 {
 #define GETLCD_IMPORT
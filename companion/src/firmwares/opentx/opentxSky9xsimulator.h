@@ -36,6 +36,12 @@ class Open9xSky9xSimulator : public SimulatorInterface {
 
     virtual bool timer10ms();
 
+    virtual void setSpeed(unsigned int speed);
+
+    virtual void saveState(QByteArray & state);
+
+    virtual bool restoreState(const QByteArray & state);
+
     virtual uint8_t * getLcd();
 
     virtual bool lcdChanged(bool & lightEnable);
@@ -244,6 +244,24 @@ bool OpentxTaranisSimulator::timer10ms()
 #include "simulatorimport.h"
 }
 
+void OpentxTaranisSimulator::setSpeed(unsigned int speed)
+{
+#define SETSPEED_IMPORT
+#include "simulatorimport.h"
+}
+
+void OpentxTaranisSimulator::saveState(QByteArray & state)
+{
+#define SAVESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
+bool OpentxTaranisSimulator::restoreState(const QByteArray & state)
+{
+#define RESTORESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
 ::uint8_t * OpentxTaranisSimulator::getLcd()
 {
 #define GETLCD_IMPORT
@@ -253,6 +253,24 @@ bool OpentxTaranisX9ESimulator::timer10ms()
 #include "simulatorimport.h"
 }
 
+void OpentxTaranisX9ESimulator::setSpeed(unsigned int speed)
+{
+#define SETSPEED_IMPORT
+#include "simulatorimport.h"
+}
+
+void OpentxTaranisX9ESimulator::saveState(QByteArray & state)
+{
+#define SAVESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
+bool OpentxTaranisX9ESimulator::restoreState(const QByteArray & state)
+{
+#define RESTORESTATE_IMPORT
+#include "simulatorimport.h"
+}
+
 ::uint8_t * OpentxTaranisX9ESimulator::getLcd()
 {
 #define GETLCD_IMPORT
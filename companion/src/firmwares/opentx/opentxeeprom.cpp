@@ -3,6 +3,7 @@
 #include "helpers.h"
 #include "opentxeeprom.h"
 #include <QObject>
+#include <QMutex>
 
 #define IS_DBLEEPROM(board, version)         ((IS_2560(board) || board==BOARD_M128) && version >= 213)
 // Macro used for Gruvin9x board and M128 board between versions 213 and 214 (when there were stack overflows!)
@@ -158,11 +159,13 @@ class SwitchesConversionTable: public ConversionTable {
     };
 
     static std::list<Cache> internalCache;
+    static QMutex internalCacheMutex; // models are imported in parallel
 
   public:
 
     static SwitchesConversionTable * getInstance(BoardEnum board, unsigned int version, unsigned long flags=0)
     {
+      QMutexLocker locker(&internalCacheMutex);
       for (std::list<Cache>::iterator it=internalCache.begin(); it!=internalCache.end(); it++) {
         Cache element = *it;
         if (element.board == board && element.version == version && element.flags == flags)
@@ -184,6 +187,7 @@ class SwitchesConversionTable: public ConversionTable {
 };
 
 std::list<SwitchesConversionTable::Cache> SwitchesConversionTable::internalCache;
+QMutex SwitchesConversionTable::internalCacheMutex;
 
 #define FLAG_NONONE       0x01
 #define FLAG_NOSWITCHES   0x02
@@ -337,11 +341,13 @@ class SourcesConversionTable: public ConversionTable {
         SourcesConversionTable * table;
     };
     static std::list<Cache> internalCache;
+    static QMutex internalCacheMutex; // models are imported in parallel
 
   public:
 
     static SourcesConversionTable * getInstance(BoardEnum board, unsigned int version, unsigned int variant, unsigned long flags=0)
     {
+      QMutexLocker locker(&internalCacheMutex);
       for (std::list<Cache>::iterator it=internalCache.begin(); it!=internalCache.end(); it++) {
         Cache element = *it;
         if (element.board == board && element.version == version && element.variant == variant && element.flags == flags)
@@ -363,6 +369,7 @@ class SourcesConversionTable: public ConversionTable {
 };
 
 std::list<SourcesConversionTable::Cache> SourcesConversionTable::internalCache;
+QMutex SourcesConversionTable::internalCacheMutex;
 
 void OpenTxEepromCleanup(void)
 {
@@ -2432,7 +2439,7 @@ class FrskyScreenField: public DataField {
       }
     }
 
-    virtual void ExportBits(QBitArray & output)
+    virtual void ExportBits(BitWriter & output)
     {
       if (screen.type == TELEMETRY_SCREEN_SCRIPT)
         script.ExportBits(output);
@@ -2444,7 +2451,7 @@ class FrskyScreenField: public DataField {
         none.ExportBits(output);
     }
 
-    virtual void ImportBits(QBitArray & input)
+    virtual void ImportBits(BitReader & input)
     {
       // NOTA: screen.type should have been imported first!
       if (screen.type == TELEMETRY_SCREEN_SCRIPT)
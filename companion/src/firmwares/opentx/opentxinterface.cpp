@@ -16,6 +16,8 @@
 
 #include <iostream>
 #include <QMessageBox>
+#include <QFuture>
+#include <QtConcurrentMap>
 #include "opentxinterface.h"
 #include "opentxeeprom.h"
 #include "open9xGruvin9xeeprom.h"
@@ -312,8 +314,85 @@ bool OpenTxEepromInterface::loadxml(RadioData &radioData, QDomDocument &doc)
   return false;
 }
 
+/*
+ * A model read from the EEPROM file system, waiting to be decoded
+ */
+class ModelImport {
+  public:
+    ModelImport(ModelData & model, BoardEnum board, unsigned int version, unsigned int variant):
+      model(&model),
+      board(board),
+      version(version),
+      variant(variant)
+    {
+    }
+
+    ModelData * model;
+    BoardEnum board;
+    unsigned int version;
+    unsigned int variant;
+    QByteArray data;
+};
+
+/*
+ * The limits out of the channels range are brought back in it, like the
+ * channels editor does. GVars (beyond +/-10000) are kept.
+ */
+static void checkLimits(ModelData & model)
+{
+  int channelsMax = model.getChannelsMax() * 10;
+  for (int i=0; i<C9X_NUM_CHNOUT; i++) {
+    LimitData & limit = model.limitData[i];
+    if (limit.min >= -10000 && limit.min < -channelsMax)
+      limit.min = -channelsMax;
+    if (limit.max <= 10000 && limit.max > channelsMax)
+      limit.max = channelsMax;
+  }
+}
+
+static bool importModel(const ModelImport & import)
+{
+  if (import.data.isEmpty()) {
+    import.model->clear();
+    return false;
+  }
+
+  OpenTxModelData open9xModel(*import.model, import.board, import.version, import.variant);
+  open9xModel.Import(import.data);
+  import.model->used = true;
+  checkLimits(*import.model);
+  return true;
+}
+
+bool OpenTxEepromInterface::probe(const uint8_t *eeprom, int size)
+{
+  // load() accepts a 4096 bytes image for a 2048 bytes board when the upper half is empty
+  if (size == 4096 && getEEpromSize() == 2048)
+    size = 2048;
+  else if (size != getEEpromSize())
+    return false;
+
+  if (!efile->EeFsOpen((uint8_t *)eeprom, size, board))
+    return false;
+
+  uint8_t version;
+  efile->openRd(FILE_GENERAL);
+  return efile->readRlc2(&version, 1) == 1 && checkVersion(version);
+}
+
 bool OpenTxEepromInterface::load(RadioData &radioData, const uint8_t *eeprom, int size)
 {
+  QFuture<void> decoding;
+  if (!loadAsync(radioData, eeprom, size, decoding))
+    return false;
+  decoding.waitForFinished();
+  return true;
+}
+
+bool OpenTxEepromInterface::loadAsync(RadioData &radioData, const uint8_t *eeprom, int size, QFuture<void> &decoding)
+{
+  decoding = QFuture<void>();
+
   std::cout << "trying " << getName() << " import...";
 
   if (size != getEEpromSize()) {
@@ -364,10 +443,27 @@ bool OpenTxEepromInterface::load(RadioData &radioData, const uint8_t *eeprom, in
   }
 
   std::cout << " variant " << radioData.generalSettings.variant;
-  for (int i=0; i<getMaxModels(); i++) {
-    if (!loadModel(version, radioData.models[i], NULL, i, radioData.generalSettings.variant, radioData.generalSettings.stickMode+1)) {
-      std::cout << " ko\n";
-      return false;
+  if (version >= 213 || (version == 212 && !IS_SKY9X(board))) {
+    // the file system isn't reentrant: the models are read here, then decoded on all cores
+    QList<ModelImport> imports;
+    for (int i=0; i<getMaxModels(); i++) {
+      ModelImport import(radioData.models[i], board, version, radioData.generalSettings.variant);
+      import.data.fill(0, sizeof(ModelData)); // ModelData should be always bigger than the EEPROM struct
+      efile->openRd(FILE_MODEL(i));
+      if (!efile->readRlc2((uint8_t *)import.data.data(), import.data.size()))
+        import.data.clear();
+      imports.append(import);
+    }
+    // mapped() keeps its own copy of imports, the models are written through their pointers
+    decoding = QtConcurrent::mapped(imports, importModel);
+  }
+  else {
+    for (int i=0; i<getMaxModels(); i++) {
+      if (!loadModel(version, radioData.models[i], NULL, i, radioData.generalSettings.variant, radioData.generalSettings.stickMode+1)) {
+        std::cout << " ko\n";
+        return false;
+      }
+      checkLimits(radioData.models[i]);
     }
   }
   std::cout << " ok\n";
@@ -34,8 +34,12 @@ class OpenTxEepromInterface : public EEPROMInterface
 
     virtual const int getMaxModels();
 
+    virtual bool probe(const uint8_t *eeprom, int size);
+
     virtual bool load(RadioData &, const uint8_t *eeprom, int size);
 
+    virtual bool loadAsync(RadioData &, const uint8_t *eeprom, int size, QFuture<void> &decoding);
+
     virtual bool loadBackup(RadioData &, uint8_t *eeprom, int esize, int index);
     
     virtual bool loadxml(RadioData &radioData, QDomDocument &doc);
@@ -62,6 +62,16 @@ bool Th9xInterface::loadxml(RadioData &radioData, QDomDocument &doc)
   return false;
 }
 
+bool Th9xInterface::probe(const uint8_t *eeprom, int size)
+{
+  if (size != getEEpromSize() || !efile->EeFsOpen((uint8_t *)eeprom, size, BOARD_STOCK))
+    return false;
+
+  uint8_t version;
+  efile->openRd(FILE_GENERAL);
+  return efile->readRlc2(&version, 1) == 1 && version == 6;
+}
+
 bool Th9xInterface::load(RadioData &radioData, const uint8_t *eeprom, int size)
 {
   std::cout << "trying th9x import... ";
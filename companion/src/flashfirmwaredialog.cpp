@@ -229,6 +229,12 @@ void FlashFirmwareDialog::on_burnButton_clicked()
       QMessageBox::critical(this, tr("Warning"), tr("Cannot save customized firmware"));
       return;
     }
+    // verify the file which is going to be flashed
+    if (FirmwareInterface(tempFile).getCrc() != firmware.getCrc()) {
+      QMessageBox::critical(this, tr("Warning"), tr("Customized firmware verification failed"));
+      qunlink(tempFile);
+      return;
+    }
     startFlash(tempFile);
   }
   else {
@@ -930,6 +930,11 @@ void startSimulation(QWidget * parent, RadioData & radioData, int modelIdx)
 }
 
 QPixmap makePixMap( QImage image, QString firmwareType )
+{
+  return QPixmap::fromImage(makeSplashImage(image, firmwareType));
+}
+
+QImage makeSplashImage( QImage image, QString firmwareType )
 {
   if (firmwareType.contains( "taranis" )) {
     image = image.convertToFormat(QImage::Format_RGB32);
@@ -947,7 +952,7 @@ QPixmap makePixMap( QImage image, QString firmwareType )
   else {
     image = image.scaled(SPLASH_WIDTH, SPLASH_HEIGHT).convertToFormat(QImage::Format_Mono);
   }
-  return(QPixmap::fromImage(image));
+  return image;
 }
 
 int version2index(QString version)
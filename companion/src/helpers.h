@@ -137,6 +137,8 @@ void startSimulation(QWidget * parent, RadioData & radioData, int modelIdx);
 
 // Format a pixmap to fit on the radio using a specific firmware
 QPixmap makePixMap( QImage image, QString firmwareType );
+// Same conversion without the pixmap, usable outside of the GUI thread
+QImage makeSplashImage( QImage image, QString firmwareType );
 
 int version2index(QString version);
 QString index2version(int index);
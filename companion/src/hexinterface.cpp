@@ -14,68 +14,101 @@
  *
  */
 
+#include <string.h>
+#include <ctype.h>
 #include "hexinterface.h"
 
+static const char hexChars[] = "0123456789ABCDEF";
+
+class HexDigits {
+  public:
+    HexDigits()
+    {
+      memset(values, -1, sizeof(values));
+      for (int i=0; i<16; i++) {
+        values[(uint8_t)hexChars[i]] = i;
+        values[(uint8_t)tolower(hexChars[i])] = i;
+      }
+    }
+    int8_t values[256];
+};
+
+static const HexDigits hexDigits;
+
+// returns the byte encoded by 2 hex digits, or -1
+static inline int decodeHexByte(const uint8_t *hex)
+{
+  int high = hexDigits.values[hex[0]];
+  int low = hexDigits.values[hex[1]];
+  return (high < 0 || low < 0) ? -1 : (high << 4) + low;
+}
+
 HexInterface::HexInterface(QTextStream &stream):
   stream(stream)
 {
 }
 
-int HexInterface::getValueFromLine(const QString &line, int pos, int len)
+int HexInterface::load(uint8_t *data, int maxsize)
 {
-    bool ok;
-    int hex = line.mid(pos,len).toInt(&ok, 16);
-    return ok ? hex : -1;
+  QByteArray hex = stream.readAll().toLatin1();
+  return parse((const uint8_t *)hex.constData(), hex.size(), data, maxsize);
 }
 
-int HexInterface::load(uint8_t *data, int maxsize)
+int HexInterface::parse(const uint8_t *hex, qint64 size, uint8_t *data, int maxsize)
 {
   int result = 0;
   int offset = 0;
-  while (!stream.atEnd()) {
-    QString line = stream.readLine();
-
-    if(line.left(1)!=":") continue;
-    
-    int byteCount = getValueFromLine(line,1);
-    int address = getValueFromLine(line,3,4);
-    int recType = getValueFromLine(line,7);
-    if (recType==0x02) {
+  const uint8_t *end = hex + size;
+  const uint8_t *line = hex;
+  while (line < end) {
+    const uint8_t *eol = (const uint8_t *)memchr(line, '\n', end - line);
+    if (!eol) eol = end;
+
+    if (*line == ':') {
+      if (eol - line < 11)
+        return 0;
+
+      int byteCount = decodeHexByte(line+1);
+      int addressHigh = decodeHexByte(line+3);
+      int addressLow = decodeHexByte(line+5);
+      int recType = decodeHexByte(line+7);
+      if (recType==0x02) {
         offset+=0x010000;
-    }
-    if(byteCount<0 || address<0 || recType<0)
-      return 0;
-
-    QByteArray ba;
-    ba.clear();
-
-    quint8 chkSum = 0;
-    chkSum -= byteCount;
-    chkSum -= recType;
-    chkSum -= address & 0xFF;
-    chkSum -= address >> 8;
-    for(int i=0; i<byteCount; i++)
-    {
-        quint8 v = getValueFromLine(line,(i*2)+9) & 0xFF;
+      }
+      if (byteCount<0 || addressHigh<0 || addressLow<0 || recType<0 || eol - line < 11 + 2*byteCount)
+        return 0;
+
+      int address = (addressHigh << 8) + addressLow;
+      if (address+offset + byteCount > maxsize)
+        return 0;
+
+      quint8 chkSum = 0;
+      chkSum -= byteCount;
+      chkSum -= recType;
+      chkSum -= addressLow;
+      chkSum -= addressHigh;
+      const uint8_t *digits = line + 9;
+      uint8_t *dest = &data[address+offset];
+      for (int i=0; i<byteCount; i++, digits+=2) {
+        int v = decodeHexByte(digits);
+        if (v < 0)
+          return 0;
         chkSum -= v;
-        ba.append(v);
-    }
+        if (recType == 0x00) // data record
+          dest[i] = v;
+      }
 
-    quint8 retV = getValueFromLine(line,(byteCount*2)+9) & 0xFF;
-    if(chkSum!=retV)
-      return 0;
+      if (decodeHexByte(digits) != chkSum)
+        return 0;
 
-    if (address+offset + byteCount <= maxsize) {
-      if (recType == 0x00) { //data record - ba holds record
-        memcpy(&data[address+offset],ba.data(),byteCount);
+      if (recType == 0x00) {
         result = std::max(result, address+offset+byteCount);
       }
     }
-    else {
-      return 0;
-    }
+
+    line = eol + 1;
   }
-  
+
   return result;
 }
 
@@ -101,20 +134,32 @@ bool HexInterface::save(uint8_t *data, const int size)
 
 QString HexInterface::iHEXLine(quint8 * data, quint32 addr, quint8 len)
 {
+  char line[11 + 2*255 + 1];
+  char *str = line;
   unsigned int bankaddr;
   bankaddr=addr&0xffff;
-  QString str = QString(":%1%2000").arg(len, 2, 16, QChar('0')).arg(bankaddr, 4, 16, QChar('0')); //write start, bytecount (32), address and record type
   quint8 chkSum = 0;
   chkSum = -len; //-bytecount; recordtype is zero
   chkSum -= bankaddr & 0xFF;
   chkSum -= bankaddr >> 8;
+  //write start, bytecount (32), address and record type
+  *str++ = ':';
+  *str++ = hexChars[len >> 4];
+  *str++ = hexChars[len & 0x0F];
+  *str++ = hexChars[(bankaddr >> 12) & 0x0F];
+  *str++ = hexChars[(bankaddr >> 8) & 0x0F];
+  *str++ = hexChars[(bankaddr >> 4) & 0x0F];
+  *str++ = hexChars[bankaddr & 0x0F];
+  *str++ = '0';
+  *str++ = '0';
   for (int j = 0; j < len; j++) {
-    str += QString("%1").arg(data[addr + j], 2, 16, QChar('0'));
+    *str++ = hexChars[data[addr + j] >> 4];
+    *str++ = hexChars[data[addr + j] & 0x0F];
     chkSum -= data[addr + j];
   }
-
-  str += QString("%1").arg(chkSum, 2, 16, QChar('0'));
-  return str.toUpper(); // output to file and lf;
+  *str++ = hexChars[chkSum >> 4];
+  *str++ = hexChars[chkSum & 0x0F];
+  return QString::fromLatin1(line, str - line); // output to file and lf;
 }
 
 QString HexInterface::iHEXExtRec(quint8 bank)
@@ -26,9 +26,11 @@ class HexInterface {
     int load(uint8_t *output, int maxsize);
     bool save(uint8_t *data, const int size);
 
+    // parses HEX text already in memory (e.g. a mapped file)
+    static int parse(const uint8_t *hex, qint64 size, uint8_t *output, int maxsize);
+
   protected:
 
-    int getValueFromLine(const QString &line, int pos, int len=2);
     QString iHEXLine(quint8 * data, quint32 addr, quint8 len);
     QString iHEXExtRec(quint8 bank);
 
@@ -54,6 +54,7 @@
 #include "wizarddialog.h"
 #include "flashfirmwaredialog.h"
 #include <QFileInfo>
+#include <QFutureWatcher>
 
 #if defined WIN32 || !defined __GNUC__
 #include <windows.h>
@@ -227,6 +228,31 @@ void MdiChild::newFile()
   updateTitle();
 }
 
+/*
+ * The models are decoded on all cores, their progress is shown meanwhile
+ */
+bool MdiChild::loadEEprom(const uint8_t *eeprom, int size)
+{
+  QFuture<void> decoding;
+  if (!::loadEEprom(radioData, eeprom, size, &decoding))
+    return false;
+
+  if (!decoding.isFinished()) {
+    QProgressDialog progress(tr("Loading models..."), QString(), 0, 0, this);
+    progress.setWindowModality(Qt::WindowModal);
+    QFutureWatcher<void> watcher;
+    connect(&watcher, SIGNAL(progressRangeChanged(int, int)), &progress, SLOT(setRange(int, int)));
+    connect(&watcher, SIGNAL(progressValueChanged(int)), &progress, SLOT(setValue(int)));
+    connect(&watcher, SIGNAL(finished()), &progress, SLOT(reset()));
+    watcher.setFuture(decoding);
+    // the watcher signals are queued, finished() always ends exec()
+    progress.exec();
+    watcher.waitForFinished();
+  }
+
+  return true;
+}
+
 bool MdiChild::loadFile(const QString &fileName, bool resetCurrentFile)
 {
     QFile file(fileName);
@@ -294,7 +320,7 @@ bool MdiChild::loadFile(const QString &fileName, bool resetCurrentFile)
 
       file.close();
 
-      if (!loadEEprom(radioData, eeprom, eeprom_size)) {
+      if (!loadEEprom(eeprom, eeprom_size)) {
         QMessageBox::critical(this, tr("Error"),
             tr("Invalid EEPROM File %1")
             .arg(fileName));
@@ -330,7 +356,7 @@ bool MdiChild::loadFile(const QString &fileName, bool resetCurrentFile)
           return false;
       }
 
-      if (!loadEEprom(radioData, eeprom, eeprom_size) && !::loadBackup(radioData, eeprom, eeprom_size, 0)) {
+      if (!loadEEprom(eeprom, eeprom_size) && !::loadBackup(radioData, eeprom, eeprom_size, 0)) {
         QMessageBox::critical(this, tr("Error"),
             tr("Invalid binary EEPROM File %1")
             .arg(fileName));
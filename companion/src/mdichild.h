@@ -107,6 +107,7 @@ class MdiChild : public QWidget
 
   private:
     bool maybeSave();
+    bool loadEEprom(const uint8_t *eeprom, int size);
     void setCurrentFile(const QString &fileName);
     QString strippedName(const QString &fullFileName);
     void saveSelection();
@@ -0,0 +1,73 @@
+#include <string.h>
+#include "modeldiff.h"
+
+template <class T>
+void ModelDiff::compare(ModelDiffSection section, const T & value1, const T & value2, int index)
+{
+  // the model structures are compared as raw memory, as everywhere else in companion
+  if (memcmp(&value1, &value2, sizeof(T))) {
+    ModelChange change = { section, index };
+    changeList.append(change);
+    sections |= (1 << section);
+  }
+}
+
+template <class T, int N>
+void ModelDiff::compareItems(ModelDiffSection section, const T (&items1)[N], const T (&items2)[N])
+{
+  for (int i=0; i<N; i++) {
+    compare(section, items1[i], items2[i], i);
+  }
+}
+
+ModelDiff::ModelDiff(const ModelData & model1, const ModelData & model2):
+  sections(0)
+{
+  compare(MODEL_DIFF_SETUP, model1.name, model2.name);
+  compareItems(MODEL_DIFF_SETUP, model1.timers, model2.timers);
+  compare(MODEL_DIFF_SETUP, model1.noGlobalFunctions, model2.noGlobalFunctions);
+  compare(MODEL_DIFF_SETUP, model1.thrTrim, model2.thrTrim);
+  compare(MODEL_DIFF_SETUP, model1.trimInc, model2.trimInc);
+  compare(MODEL_DIFF_SETUP, model1.trimsDisplay, model2.trimsDisplay);
+  compare(MODEL_DIFF_SETUP, model1.disableThrottleWarning, model2.disableThrottleWarning);
+  compare(MODEL_DIFF_SETUP, model1.beepANACenter, model2.beepANACenter);
+  compare(MODEL_DIFF_SETUP, model1.extendedLimits, model2.extendedLimits);
+  compare(MODEL_DIFF_SETUP, model1.extendedTrims, model2.extendedTrims);
+  compare(MODEL_DIFF_SETUP, model1.throttleReversed, model2.throttleReversed);
+  compare(MODEL_DIFF_SETUP, model1.swashRingData, model2.swashRingData);
+  compare(MODEL_DIFF_SETUP, model1.thrTraceSrc, model2.thrTraceSrc);
+  compare(MODEL_DIFF_SETUP, model1.modelId, model2.modelId);
+  compare(MODEL_DIFF_SETUP, model1.switchWarningStates, model2.switchWarningStates);
+  compare(MODEL_DIFF_SETUP, model1.switchWarningEnable, model2.switchWarningEnable);
+  compare(MODEL_DIFF_SETUP, model1.potsWarningMode, model2.potsWarningMode);
+  compare(MODEL_DIFF_SETUP, model1.potsWarningEnabled, model2.potsWarningEnabled);
+  compare(MODEL_DIFF_SETUP, model1.potPosition, model2.potPosition);
+  compare(MODEL_DIFF_SETUP, model1.displayChecklist, model2.displayChecklist);
+  compare(MODEL_DIFF_SETUP, model1.bitmap, model2.bitmap);
+  compare(MODEL_DIFF_SETUP, model1.trainerMode, model2.trainerMode);
+  compareItems(MODEL_DIFF_SETUP, model1.moduleData, model2.moduleData);
+  compareItems(MODEL_DIFF_SETUP, model1.scriptData, model2.scriptData);
+
+  compareItems(MODEL_DIFF_FLIGHT_MODES, model1.flightModeData, model2.flightModeData);
+
+  compare(MODEL_DIFF_INPUTS, model1.inputNames, model2.inputNames);
+  compareItems(MODEL_DIFF_INPUTS, model1.expoData, model2.expoData);
+
+  compareItems(MODEL_DIFF_MIXES, model1.mixData, model2.mixData);
+
+  compareItems(MODEL_DIFF_LIMITS, model1.limitData, model2.limitData);
+
+  compareItems(MODEL_DIFF_CURVES, model1.curves, model2.curves);
+
+  compareItems(MODEL_DIFF_GVARS, model1.gvars_names, model2.gvars_names);
+  compareItems(MODEL_DIFF_GVARS, model1.gvars_popups, model2.gvars_popups);
+
+  compareItems(MODEL_DIFF_LOGICAL_SWITCHES, model1.logicalSw, model2.logicalSw);
+
+  compareItems(MODEL_DIFF_CUSTOM_FUNCTIONS, model1.customFn, model2.customFn);
+
+  compare(MODEL_DIFF_TELEMETRY, model1.telemetryProtocol, model2.telemetryProtocol);
+  compare(MODEL_DIFF_TELEMETRY, model1.frsky, model2.frsky);
+  compare(MODEL_DIFF_TELEMETRY, model1.mavlink, model2.mavlink);
+  compareItems(MODEL_DIFF_TELEMETRY, model1.sensorData, model2.sensorData);
+}
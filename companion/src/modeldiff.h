@@ -0,0 +1,50 @@
+#ifndef MODELDIFF_H_
+#define MODELDIFF_H_
+
+#include <QList>
+#include "eeprominterface.h"
+
+enum ModelDiffSection {
+  MODEL_DIFF_SETUP,
+  MODEL_DIFF_FLIGHT_MODES,
+  MODEL_DIFF_INPUTS,
+  MODEL_DIFF_MIXES,
+  MODEL_DIFF_LIMITS,
+  MODEL_DIFF_CURVES,
+  MODEL_DIFF_GVARS,
+  MODEL_DIFF_LOGICAL_SWITCHES,
+  MODEL_DIFF_CUSTOM_FUNCTIONS,
+  MODEL_DIFF_TELEMETRY,
+  MODEL_DIFF_SECTIONS_COUNT
+};
+
+struct ModelChange {
+  ModelDiffSection section;
+  int index; // index of the item in the section, -1 for the section settings
+};
+
+/*
+ * Structural comparison of two models, done in one pass when constructed
+ */
+class ModelDiff {
+  public:
+    ModelDiff(const ModelData & model1, const ModelData & model2);
+
+    const QList<ModelChange> & changes() const { return changeList; }
+
+    bool isEmpty() const { return changeList.isEmpty(); }
+
+    bool hasChanges(ModelDiffSection section) const { return sections & (1 << section); }
+
+  protected:
+    template <class T>
+    void compare(ModelDiffSection section, const T & value1, const T & value2, int index=-1);
+
+    template <class T, int N>
+    void compareItems(ModelDiffSection section, const T (&items1)[N], const T (&items2)[N]);
+
+    QList<ModelChange> changeList;
+    unsigned int sections;
+};
+
+#endif /* MODELDIFF_H_ */
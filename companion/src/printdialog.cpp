@@ -7,6 +7,8 @@
 #include <QImage>
 #include <QColor>
 #include <QPainter>
+#include <QtConcurrentRun>
+#include <QCryptographicHash>
 
 #if !defined WIN32 && defined __GNUC__
 #include <unistd.h>
@@ -15,14 +17,21 @@
 #define ISIZE 200 // curve image size
 #define ISIZEW 400 // curve image size
 
+// HTML of the model sections, shared by all print dialogs and keyed by
+// model revision + section, the cost being the length of the HTML
+static QCache<QByteArray, QString> sectionsCache(1024*1024);
+static QMutex sectionsCacheMutex;
+
 PrintDialog::PrintDialog(QWidget *parent, Firmware * firmware, GeneralSettings *gg, ModelData *gm, QString filename) :
   QDialog(parent, Qt::WindowTitleHint | Qt::WindowSystemMenuHint),
   firmware(firmware),
-  g_eeGeneral(gg),
-  g_model(gm),
+  g_eeGeneral(&generalSettings),
+  g_model(&model),
   printfilename(filename),
   ui(new Ui::PrintDialog),
-  gvars(firmware->getCapability(Gvars))
+  gvars(firmware->getCapability(Gvars)),
+  generalSettings(*gg),
+  model(*gm)
 {
   ui->setupUi(this);
   setWindowIcon(CompanionIcon("print.png"));
@@ -39,24 +48,24 @@ PrintDialog::PrintDialog(QWidget *parent, Firmware * firmware, GeneralSettings *
     curvefile5=generateProcessUniqueTempFileName(QString("%1-curve5.png").arg(modelname));
     curvefile9=generateProcessUniqueTempFileName(QString("%1-curve9.png").arg(modelname));
   }
-  printSetup(); 
-  if (gvars) {
-    te->append(printFlightModes()+"<br>");
-  }
-  printInputs();
-  printMixes();
-  printLimits();
-  printCurves();
-  printGvars();
-  printSwitches();
-  printFSwitches();
-  printFrSky();
-  
-  te->scrollToAnchor("1");
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(firmware->getId().toAscii());
+  hash.addData((const char *)&model, sizeof(ModelData));
+  hash.addData((const char *)&generalSettings, sizeof(GeneralSettings));
+  revision = hash.result();
+
+  connect(this, SIGNAL(sectionPrinted(int, const QString &)), this, SLOT(onSectionPrinted(int, const QString &)));
+
   if (!printfilename.isEmpty()) {
+    printSections();
     printToFile();
     QTimer::singleShot(0, this, SLOT(autoClose()));
   }
+  else {
+    // sections are appended as soon as the worker has printed them
+    printing = QtConcurrent::run(this, &PrintDialog::printSections);
+  }
 }
 
 void PrintDialog::closeEvent(QCloseEvent *event) 
@@ -66,12 +75,100 @@ void PrintDialog::closeEvent(QCloseEvent *event)
 PrintDialog::~PrintDialog()
 {
   // notice PrintDialog::closeEvent() is not called if user clicks on Close button
+  printing.waitForFinished();
   qunlink(curvefile5);
   qunlink(curvefile9);
   delete ui;
 }
 
-void PrintDialog::printSetup()
+QString PrintDialog::printSection(int section)
+{
+  switch (section) {
+    case SECTION_SETUP:
+      return printSetup();
+    case SECTION_FLIGHT_MODES:
+      return gvars ? printFlightModes()+"<br>" : QString();
+    case SECTION_INPUTS:
+      return printInputs();
+    case SECTION_MIXES:
+      return printMixes();
+    case SECTION_LIMITS:
+      return printLimits();
+    case SECTION_CURVES:
+      return printCurves();
+    case SECTION_GVARS:
+      return printGvars();
+    case SECTION_SWITCHES:
+      return printSwitches();
+    case SECTION_FSWITCHES:
+      return printFSwitches();
+    case SECTION_FRSKY:
+      return printFrSky();
+    default:
+      return QString();
+  }
+}
+
+void PrintDialog::printSections()
+{
+  for (int section=0; section<SECTION_COUNT; section++) {
+    // the setup holds the print date and the curves their image file, they are always printed
+    bool cacheable = (section != SECTION_SETUP && section != SECTION_CURVES);
+    QByteArray key = revision + char(section);
+    QString str;
+    bool cached = false;
+    if (cacheable) {
+      QMutexLocker locker(&sectionsCacheMutex);
+      QString * html = sectionsCache.object(key);
+      if (html) {
+        str = *html;
+        cached = true;
+      }
+    }
+    if (!cached) {
+      str = printSection(section);
+      if (cacheable) {
+        QMutexLocker locker(&sectionsCacheMutex);
+        sectionsCache.insert(key, new QString(str), str.size());
+      }
+    }
+    emit sectionPrinted(section, str);
+  }
+}
+
+void PrintDialog::onSectionPrinted(int section, const QString & html)
+{
+  if (!html.isEmpty()) {
+    te->append(html);
+  }
+  if (section == SECTION_COUNT-1) {
+    te->scrollToAnchor("1");
+  }
+}
+
+QString PrintDialog::sourceString(RawSource source)
+{
+  QHash<int, QString>::const_iterator it = sourceStrings.constFind(source.toValue());
+  if (it != sourceStrings.constEnd()) {
+    return it.value();
+  }
+  QString result = source.toString(g_model);
+  sourceStrings.insert(source.toValue(), result);
+  return result;
+}
+
+QString PrintDialog::switchString(RawSwitch swtch)
+{
+  QHash<int, QString>::const_iterator it = switchStrings.constFind(swtch.toValue());
+  if (it != switchStrings.constEnd()) {
+    return it.value();
+  }
+  QString result = swtch.toString();
+  switchStrings.insert(swtch.toValue(), result);
+  return result;
+}
+
+QString PrintDialog::printSetup()
 {
     QString str = "<a name=1></a><table border=1 cellspacing=0 cellpadding=3 width=\"100%\">";
     str.append(QString("<tr><td colspan=%1 ><table border=0 width=\"100%\"><tr><td><h1>").arg((firmware->getCapability(FlightModes) && !gvars) ? 2 : 1));
@@ -97,7 +194,7 @@ void PrintDialog::printSetup()
       str.append("</td>");
     }
     str.append("</tr></table><br>");
-    te->append(str);
+    return str;
 }
 
 QString PrintDialog::printFlightModes()
@@ -161,14 +258,14 @@ QString PrintDialog::printFlightModes()
           str.append(QString("<td align=\"right\"><font size=+1 face='Courier New' color=green>")+tr("FM")+QString("%1</font></td>").arg(num));
         }
       }      
-      str.append(QString("<td align=center><font size=+1 face='Courier New' color=green>%1</font></td>").arg(pd->swtch.toString()));
+      str.append(QString("<td align=center><font size=+1 face='Courier New' color=green>%1</font></td>").arg(switchString(pd->swtch)));
       str.append("</tr>");
     }
     str.append("</table>");
     return(str);
 }
 
-void PrintDialog::printInputs()
+QString PrintDialog::printInputs()
 {
     QString str = "<table border=1 cellspacing=0 cellpadding=3 width=\"100%\"><tr><td><h2>";
     str.append(tr("Inputs"));
@@ -203,9 +300,9 @@ void PrintDialog::printInputs()
       str += "&nbsp;" + tr("Weight") + QString("(%1)").arg(getGVarString(ed->weight,true));
   
       if (firmware->getCapability(VirtualInputs)) {
-        str += " " + tr("Source") + QString("(%1)").arg(ed->srcRaw.toString(g_model));
+        str += " " + tr("Source") + QString("(%1)").arg(sourceString(ed->srcRaw));
         if (ed->carryTrim>0) str += " " + tr("NoTrim");
-        else if (ed->carryTrim<0) str += " " + RawSource(SOURCE_TYPE_TRIM, (-(ed->carryTrim)-1)).toString(g_model);
+        else if (ed->carryTrim<0) str += " " + sourceString(RawSource(SOURCE_TYPE_TRIM, (-(ed->carryTrim)-1)));
       }
       if (ed->curve.value) str += " " + Qt::escape(ed->curve.toString());
 
@@ -238,17 +335,18 @@ void PrintDialog::printInputs()
           }
         }
       } 
-      if (ed->swtch.type) str += " " + tr("Switch") + QString("(%1)").arg(ed->swtch.toString());
+      if (ed->swtch.type) str += " " + tr("Switch") + QString("(%1)").arg(switchString(ed->swtch));
       if (firmware->getCapability(HasExpoNames) && ed->name[0]) str += Qt::escape(QString(" [%1]").arg(ed->name));
       str += "</font></td></tr>";
     }
     str += "</table></td></tr></table><br>";
     if (ec>0)
-      te->append(str);
+      return str;
+    return QString();
 }
 
 
-void PrintDialog::printMixes()
+QString PrintDialog::printMixes()
 {
     QString str = "<table border=1 cellspacing=0 cellpadding=3 style=\"page-break-after:always;\" width=\"100%\"><tr><td><h2>";
     str.append(tr("Mixers"));
@@ -287,20 +385,20 @@ void PrintDialog::printMixes()
         default:  str += "&nbsp;&nbsp;"; break;
       };
 
-      str += " " + md->srcRaw.toString(g_model);
+      str += " " + sourceString(md->srcRaw);
       str += " " + Qt::escape(tr("Weight(%1)").arg(getGVarString(md->weight, true)));
 
       QString phasesStr = getPhasesStr(md->phases, g_model);
       if (!phasesStr.isEmpty()) str += " " + Qt::escape(phasesStr);
 
       if (md->swtch.type != SWITCH_TYPE_NONE) {
-        str += " " + Qt::escape(tr("Switch(%1)").arg(md->swtch.toString()));
+        str += " " + Qt::escape(tr("Switch(%1)").arg(switchString(md->swtch)));
       }
 
       if (md->carryTrim>0)
         str += " " + Qt::escape(tr("NoTrim"));
       else if (md->carryTrim<0)
-        str += " " + RawSource(SOURCE_TYPE_TRIM, (-(md->carryTrim)-1)).toString(g_model);
+        str += " " + sourceString(RawSource(SOURCE_TYPE_TRIM, (-(md->carryTrim)-1)));
 
       if (firmware->getCapability(HasNoExpo) && md->noExpo) str += " " + Qt::escape(tr("No DR/Expo"));
       if (md->sOffset)     str += " " + Qt::escape(tr("Offset(%1)").arg(getGVarString(md->sOffset)));
@@ -325,10 +423,10 @@ void PrintDialog::printMixes()
       str.append("</font></td></tr>");
     }
     str.append("</table></td></tr></table><br>");
-    te->append(str);
+    return str;
 }
 
-void PrintDialog::printLimits()
+QString PrintDialog::printLimits()
 {
     QString str = "<table border=1 cellspacing=0 cellpadding=3 width=\"100%\">";
     int numcol;
@@ -431,10 +529,10 @@ void PrintDialog::printLimits()
     str.append("</tr>");
     str.append("</table>");
     str.append("<br>");
-    te->append(str);
+    return str;
 }
 
-void PrintDialog::printCurves()
+QString PrintDialog::printCurves()
 {
     int i,r,g,b,c,count;
     char buffer[16];
@@ -538,10 +636,10 @@ void PrintDialog::printCurves()
       qi.save(curvefile5, "png",100); 
       
     }
-    te->append(str);
+    return str;
 }
 
-void PrintDialog::printSwitches()
+QString PrintDialog::printSwitches()
 {
     int sc=0;
     QString str = "<table border=1 cellspacing=0 cellpadding=3 width=\"100%\">";
@@ -561,10 +659,11 @@ void PrintDialog::printSwitches()
     str.append("</table></td></tr></table>");
     str.append("<br>");
     if (sc!=0)
-      te->append(str);
+      return str;
+    return QString();
 }
 
-void PrintDialog::printGvars()
+QString PrintDialog::printGvars()
 {
   if (!firmware->getCapability(GvarsFlightModes) && gvars) {
     QString str = "<table border=1 cellspacing=0 cellpadding=3 width=\"100%\">";
@@ -584,11 +683,12 @@ void PrintDialog::printGvars()
     str.append("</tr>");
     str.append("</table></td></tr></table>");
     str.append("<br>");
-    te->append(str);
+    return str;
   }
+  return QString();
 }
 
-void PrintDialog::printFSwitches()
+QString PrintDialog::printFSwitches()
 {
     int sc=0;
     QString str = "<table border=1 cellspacing=0 cellpadding=3 width=\"100%\">";
@@ -605,7 +705,7 @@ void PrintDialog::printFSwitches()
       if (g_model->customFn[i].swtch.type!=SWITCH_TYPE_NONE) {
           str.append("<tr>");
           str.append(doTL(tr("SF%1").arg(i+1),"", true));
-          str.append(doTL(g_model->customFn[i].swtch.toString(),"green"));
+          str.append(doTL(switchString(g_model->customFn[i].swtch),"green"));
           str.append(doTL(g_model->customFn[i].funcToString(),"green"));
           str.append(doTL(g_model->customFn[i].paramToString(),"green"));
           int index=g_model->customFn[i].func;
@@ -627,10 +727,11 @@ void PrintDialog::printFSwitches()
     str.append("</table></td></tr></table>");
     str.append("<br>");
     if (sc!=0)
-      te->append(str);
+      return str;
+    return QString();
 }
 
-void PrintDialog::printFrSky()
+QString PrintDialog::printFrSky()
 {
   int tc=0;
   QString str = "<table border=1 cellspacing=0 cellpadding=3 width=\"100%\">";
@@ -767,7 +868,8 @@ void PrintDialog::printFrSky()
   }
 #endif
   if (tc>0)
-      te->append(str);    
+      return str;
+  return QString();
 }
 
 void PrintDialog::on_printButton_clicked()
@@ -4,6 +4,7 @@
 #include <QDialog>
 #include <QtGui>
 #include <QDir>
+#include <QFuture>
 #include "eeprominterface.h"
 
 namespace Ui {
@@ -26,21 +27,49 @@ public:
 
     QString printfilename;
 
+signals:
+    void sectionPrinted(int section, const QString & html);
+
 private:
+    enum Section {
+      SECTION_SETUP,
+      SECTION_FLIGHT_MODES,
+      SECTION_INPUTS,
+      SECTION_MIXES,
+      SECTION_LIMITS,
+      SECTION_CURVES,
+      SECTION_GVARS,
+      SECTION_SWITCHES,
+      SECTION_FSWITCHES,
+      SECTION_FRSKY,
+      SECTION_COUNT
+    };
+
     Ui::PrintDialog *ui;
     unsigned int gvars;
 
-    void printSetup();
+    // private copies, the sections are printed from a worker thread
+    GeneralSettings generalSettings;
+    ModelData model;
+    QByteArray revision;
+    QFuture<void> printing;
+    QHash<int, QString> sourceStrings;
+    QHash<int, QString> switchStrings;
+
+    void printSections();
+    QString printSection(int section);
+    QString sourceString(RawSource source);
+    QString switchString(RawSwitch swtch);
+    QString printSetup();
     QString printFlightModes();
-    void printInputs();
-    void printMixes();
-    void printLimits();
-    void printCurves();
-    void printGvars();
-    void printSwitches();
-    void printSafetySwitches();
-    void printFSwitches();
-    void printFrSky();
+    QString printInputs();
+    QString printMixes();
+    QString printLimits();
+    QString printCurves();
+    QString printGvars();
+    QString printSwitches();
+    QString printFSwitches();
+    QString printFrSky();
     void printToFile();
     
     QTextEdit * te;
@@ -52,6 +81,7 @@ private slots:
     void on_printButton_clicked();
     void on_printFileButton_clicked();
     void autoClose();
+    void onSectionPrinted(int section, const QString & html);
 };
 
 #endif // PRINTDIALOG_H
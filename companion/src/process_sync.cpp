@@ -1,123 +1,325 @@
 #include "process_sync.h"
 #include "progresswidget.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDesktopServices>
 #include <QDirIterator>
 #include <QDateTime>
 #include <QMessageBox>
-#include <QTextStream>
+#include <QRunnable>
+#include <QTemporaryFile>
+#include <QThreadPool>
+#include <QTime>
 #include <QDebug>
 
+#define SYNC_WORKERS          4
+#define SYNC_BUFFER_SIZE      (1024*1024)
+#define SYNC_MANIFEST_MAGIC   0x53594E43 // 'SYNC'
+#define SYNC_MANIFEST_VERSION 1
+
+static QDataStream & operator << (QDataStream &out, const SyncEntry &entry)
+{
+  return out << entry.isDir << entry.size << entry.mtime << entry.hash;
+}
+
+static QDataStream & operator >> (QDataStream &in, SyncEntry &entry)
+{
+  return in >> entry.isDir >> entry.size >> entry.mtime >> entry.hash;
+}
+
+// replaces the destination by a completely written temporary file of the same folder
+static bool replaceFile(QTemporaryFile &temporary, const QString &destination)
+{
+  temporary.close();
+  if (QFile::exists(destination) && !QFile::remove(destination)) {
+    return false;
+  }
+  if (!temporary.rename(destination)) {
+    return false;
+  }
+  temporary.setAutoRemove(false);
+  return true;
+}
+
+class SyncCopyTask : public QRunnable
+{
+  public:
+    SyncCopyTask(SyncProcess *process, SyncProcess::CopyJob &job):
+      process(process),
+      job(job)
+    {
+    }
+
+    virtual void run()
+    {
+      process->copyFile(job);
+    }
+
+  protected:
+    SyncProcess *process;
+    SyncProcess::CopyJob &job;
+};
+
 SyncProcess::SyncProcess(const QString &folder1, const QString &folder2, ProgressWidget *progress):
 folder1(folder1),
 folder2(folder2),
 progress(progress),
-simulation(false),
-index(0)
+filesDone(0),
+bytesDone(0)
 {
 }
 
 void SyncProcess::run()
-{
-  simulation = true;
-  index = 0;
-  if (synchronize()) {
-    int count = index;
-    progress->setMaximum(count);
-    simulation = false;
-    index = 0;
-    synchronize();
-    progress->setValue(count);
-  }
-}
-
-bool SyncProcess::synchronize()
 {
   if (!QFile::exists(folder1)) {
     QMessageBox::warning(NULL, QObject::tr("Synchronization error"), QObject::tr("The directory '%1' doesn't exist!").arg(folder1));
-    return false;
+    return;
   }
   if (!QFile::exists(folder2)) {
     QMessageBox::warning(NULL, QObject::tr("Synchronization error"), QObject::tr("The directory '%1' doesn't exist!").arg(folder2));
-    return false;
+    return;
+  }
+
+  QTime timer;
+  timer.start();
+
+  manifest1 = buildManifest(folder1);
+  manifest2 = buildManifest(folder2);
+  synchronize();
+
+  progress->setMaximum(jobs.count());
+  QThreadPool pool;
+  pool.setMaxThreadCount(SYNC_WORKERS);
+  for (int i=0; i<jobs.count(); i++) {
+    progress->addText(tr("Copy %1 to %2\n").arg(jobs[i].source).arg(jobs[i].destination));
+    pool.start(new SyncCopyTask(this, jobs[i]));
+  }
+  while (!pool.waitForDone(100)) {
+    progress->setValue(filesDone);
+    QCoreApplication::processEvents();
+  }
+  progress->setValue(jobs.count());
+
+  // the copies get the source hash, so that they are not read again next time
+  foreach (const CopyJob &job, jobs) {
+    if (job.done) {
+      SyncEntry entry = job.sourceEntry;
+      entry.mtime = QFileInfo(job.destination).lastModified().toTime_t();
+      job.destinationManifest->insert(job.relativePath, entry);
+    }
   }
-  QStringList errors = updateDir(folder1, folder2) + updateDir(folder2, folder1);
+  saveManifest(folder1, manifest1);
+  saveManifest(folder2, manifest2);
+
+  int elapsed = qMax(1, timer.elapsed());
+  progress->addText(tr("%1 files copied, %2 kB in %3 s (%4 kB/s)\n").arg((int)filesDone).arg(bytesDone / 1024).arg(elapsed / 1000.0, 0, 'f', 1).arg(bytesDone * 1000 / 1024 / elapsed));
+
   if (errors.count() > 0) {
     QMessageBox::warning(NULL, QObject::tr("Synchronization error"), errors.join("\n"));
-    return false;
   }
-  return true;
 }
 
-QStringList SyncProcess::updateDir(const QDir &source, const QDir &destination)
+void SyncProcess::synchronize()
 {
-  QDirIterator it(source, QDirIterator::Subdirectories);
-  while (it.hasNext()) {
-    if (!simulation) {
-      progress->setValue(index);
+  QStringList paths = manifest1.keys();
+  foreach (const QString &relativePath, manifest2.keys()) {
+    if (!manifest1.contains(relativePath)) {
+      paths << relativePath;
+    }
+  }
+  // parent directories come before their contents
+  paths.sort();
+
+  foreach (const QString &relativePath, paths) {
+    SyncManifest::iterator entry1 = manifest1.find(relativePath);
+    SyncManifest::iterator entry2 = manifest2.find(relativePath);
+    if (entry2 == manifest2.end()) {
+      if (entry1->isDir)
+        createDir(folder2, relativePath, manifest2);
+      else
+        addCopy(folder1, folder2, relativePath, *entry1, manifest2);
+    }
+    else if (entry1 == manifest1.end()) {
+      if (entry2->isDir)
+        createDir(folder1, relativePath, manifest1);
+      else
+        addCopy(folder2, folder1, relativePath, *entry2, manifest1);
+    }
+    else if (!entry1->isDir && !entry2->isDir && entry1->mtime != entry2->mtime && !isSame(*entry1, *entry2, relativePath)) {
+      if (entry1->mtime > entry2->mtime)
+        addCopy(folder1, folder2, relativePath, *entry1, manifest2);
+      else
+        addCopy(folder2, folder1, relativePath, *entry2, manifest1);
     }
+  }
+}
+
+SyncManifest SyncProcess::buildManifest(const QString &folder)
+{
+  SyncManifest previous;
+  loadManifest(folder, previous);
+
+  SyncManifest manifest;
+  QDir dir(folder);
+  QDirIterator it(folder, QDir::AllEntries | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
     QString path = it.next();
-    // qDebug() << path;
-    QFileInfo sourceInfo(path);
-    QString relativePath = source.relativeFilePath(path);
-    QString destinationPath = destination.absoluteFilePath(relativePath);
-    QFileInfo destinationInfo(destinationPath);
-    if (sourceInfo.isDir()) {
-      if (!destinationInfo.exists()) {
-        ++index;
-        if (!simulation) {
-          progress->addText(tr("Create directory %1\n").arg(destinationPath));
-          if (!destination.mkdir(relativePath)) {
-            errors << QObject::tr("Create '%1' failed").arg(destinationPath);
-            continue;
-          }
-        }
-      }
+    QFileInfo info = it.fileInfo();
+    SyncEntry entry;
+    entry.isDir = info.isDir();
+    if (!entry.isDir) {
+      entry.size = info.size();
+      entry.mtime = info.lastModified().toTime_t();
+    }
+    QString relativePath = dir.relativeFilePath(path);
+    // the hash of an unchanged file is taken from the previous run
+    SyncManifest::const_iterator cached = previous.constFind(relativePath);
+    if (cached != previous.constEnd() && cached->size == entry.size && cached->mtime == entry.mtime) {
+      entry.hash = cached->hash;
+    }
+    manifest.insert(relativePath, entry);
+  }
+  return manifest;
+}
+
+QString SyncProcess::manifestPath(const QString &folder)
+{
+  QString path = QDesktopServices::storageLocation(QDesktopServices::DataLocation) + "/sync";
+  QDir().mkpath(path);
+  QByteArray key = QCryptographicHash::hash(QDir(folder).canonicalPath().toUtf8(), QCryptographicHash::Md5).toHex();
+  return path + "/" + key + ".manifest";
+}
+
+void SyncProcess::loadManifest(const QString &folder, SyncManifest &manifest)
+{
+  QFile file(manifestPath(folder));
+  if (!file.open(QFile::ReadOnly)) {
+    return;
+  }
+  QDataStream in(&file);
+  in.setVersion(QDataStream::Qt_4_6);
+  quint32 magic, version;
+  in >> magic >> version;
+  if (magic == SYNC_MANIFEST_MAGIC && version == SYNC_MANIFEST_VERSION) {
+    in >> manifest;
+    if (in.status() != QDataStream::Ok) {
+      manifest.clear();
     }
-    else {
-      if (!destinationInfo.exists()) {
-        // qDebug() << "Copy" << path << "to" << destinationPath;
-        ++index;
-        if (!simulation) {
-          progress->addText(tr("Copy %1 to %2\n").arg(path).arg(destinationPath));
-          if (!QFile::copy(path, destinationPath)) {
-            errors << QObject::tr("Copy '%1' to '%2' failed").arg(path).arg(destinationPath);
-            continue;
-          }
-        }
+  }
+}
+
+void SyncProcess::saveManifest(const QString &folder, const SyncManifest &manifest)
+{
+  QString path = manifestPath(folder);
+  QTemporaryFile file(path + ".XXXXXX");
+  if (!file.open()) {
+    qDebug() << "Cannot write" << path;
+    return;
+  }
+  QDataStream out(&file);
+  out.setVersion(QDataStream::Qt_4_6);
+  out << (quint32)SYNC_MANIFEST_MAGIC << (quint32)SYNC_MANIFEST_VERSION << manifest;
+  if (out.status() != QDataStream::Ok || !file.flush() || !replaceFile(file, path)) {
+    qDebug() << "Cannot write" << path;
+  }
+}
+
+const QByteArray & SyncProcess::entryHash(const QString &folder, SyncEntry &entry, const QString &relativePath)
+{
+  if (entry.hash.isEmpty()) {
+    QFile file(QDir(folder).absoluteFilePath(relativePath));
+    if (file.open(QFile::ReadOnly)) {
+      QCryptographicHash hash(QCryptographicHash::Md5);
+      QByteArray buffer(SYNC_BUFFER_SIZE, 0);
+      qint64 count;
+      while ((count = file.read(buffer.data(), buffer.size())) > 0) {
+        hash.addData(buffer.constData(), count);
       }
-      else if (sourceInfo.lastModified() > destinationInfo.lastModified()) {
-        ++index;
-        if (!simulation) {
-          progress->addText(tr("Read %1\n").arg(path));
-          // retrieve source contents
-          QFile sourceFile(path);
-          if (!sourceFile.open(QFile::ReadOnly)) {
-            errors << QObject::tr("Open '%1' failed").arg(path);
-            continue;
-          }
-          QString sourceContents = sourceFile.readAll();
-          sourceFile.close();
-          // try to retrieve destination contents
-          QFile destinationFile(path);
-          if (destinationFile.open(QFile::ReadOnly)) {
-            QString destinationContents = destinationFile.readAll();
-            destinationFile.close();
-            if (sourceContents == destinationContents) {
-              // qDebug() << "Skip" << path;
-              continue;
-            }
-          }
-          if (!destinationFile.open(QFile::WriteOnly)) {
-            errors << QObject::tr("Write '%1' failed").arg(destinationPath);
-            continue;
-          }
-          progress->addText(tr("Write %1\n").arg(destinationPath));
-          // qDebug() << "Write" << destinationPath;
-          QTextStream destinationStream(&destinationFile);
-          destinationStream << sourceContents;
-          destinationFile.close();
-        }
+      if (count == 0) {
+        entry.hash = hash.result();
       }
     }
   }
-  return errors;
+  return entry.hash;
+}
+
+bool SyncProcess::isSame(SyncEntry &entry1, SyncEntry &entry2, const QString &relativePath)
+{
+  if (entry1.size != entry2.size) {
+    return false;
+  }
+  const QByteArray &hash1 = entryHash(folder1, entry1, relativePath);
+  return !hash1.isEmpty() && hash1 == entryHash(folder2, entry2, relativePath);
+}
+
+void SyncProcess::createDir(const QString &folder, const QString &relativePath, SyncManifest &manifest)
+{
+  QDir dir(folder);
+  QString path = dir.absoluteFilePath(relativePath);
+  progress->addText(tr("Create directory %1\n").arg(path));
+  if (!dir.mkpath(relativePath)) {
+    errors << QObject::tr("Create '%1' failed").arg(path);
+    return;
+  }
+  SyncEntry entry;
+  entry.isDir = true;
+  manifest.insert(relativePath, entry);
+}
+
+void SyncProcess::addCopy(const QString &source, const QString &destination, const QString &relativePath, const SyncEntry &sourceEntry, SyncManifest &destinationManifest)
+{
+  CopyJob job;
+  job.source = QDir(source).absoluteFilePath(relativePath);
+  job.destination = QDir(destination).absoluteFilePath(relativePath);
+  job.relativePath = relativePath;
+  job.destinationManifest = &destinationManifest;
+  job.sourceEntry = sourceEntry;
+  job.done = false;
+  jobs << job;
+}
+
+// called from the worker threads
+// the copy is written next to the destination and only replaces it once complete,
+// a truncated destination would otherwise be the newer file at the next sync
+void SyncProcess::copyFile(CopyJob &job)
+{
+  QFile sourceFile(job.source);
+  if (!sourceFile.open(QFile::ReadOnly)) {
+    addError(QObject::tr("Open '%1' failed").arg(job.source));
+    return;
+  }
+  QTemporaryFile destinationFile(job.destination + ".XXXXXX");
+  if (!destinationFile.open()) {
+    addError(QObject::tr("Write '%1' failed").arg(job.destination));
+    return;
+  }
+  QByteArray buffer(SYNC_BUFFER_SIZE, 0);
+  qint64 count;
+  while ((count = sourceFile.read(buffer.data(), buffer.size())) > 0) {
+    if (destinationFile.write(buffer.constData(), count) != count) {
+      addError(QObject::tr("Write '%1' failed").arg(job.destination));
+      return;
+    }
+    QMutexLocker locker(&mutex);
+    bytesDone += count;
+  }
+  if (count < 0) {
+    addError(QObject::tr("Read '%1' failed").arg(job.source));
+    return;
+  }
+  // temporary files are only readable by their owner
+  destinationFile.setPermissions(sourceFile.permissions());
+  if (!destinationFile.flush() || !replaceFile(destinationFile, job.destination)) {
+    addError(QObject::tr("Write '%1' failed").arg(job.destination));
+    return;
+  }
+  job.done = true;
+  filesDone.ref();
+}
+
+void SyncProcess::addError(const QString &error)
+{
+  QMutexLocker locker(&mutex);
+  errors << error;
 }
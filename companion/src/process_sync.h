@@ -4,27 +4,78 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QAtomicInt>
 
 class QDir;
 class ProgressWidget;
 
+class SyncEntry
+{
+  public:
+    SyncEntry():
+      isDir(false),
+      size(0),
+      mtime(0)
+    {
+    }
+
+    bool isDir;
+    qint64 size;
+    uint mtime;
+    QByteArray hash; // empty until it has been needed once
+};
+
+// the manifest of a folder, indexed by the path relative to the folder
+typedef QHash<QString, SyncEntry> SyncManifest;
+
 class SyncProcess : public QObject
 {
   Q_OBJECT
 
+  friend class SyncCopyTask;
+
 public:
   SyncProcess(const QString &folder1, const QString &folder2, ProgressWidget *progress);
   void run();
 
 protected:
-  bool synchronize();
-  QStringList updateDir(const QDir &source, const QDir &destination);
+  class CopyJob
+  {
+    public:
+      QString source;
+      QString destination;
+      QString relativePath;
+      SyncManifest * destinationManifest;
+      SyncEntry sourceEntry;
+      bool done;
+  };
+
+  void synchronize();
+  SyncManifest buildManifest(const QString &folder);
+  void loadManifest(const QString &folder, SyncManifest &manifest);
+  void saveManifest(const QString &folder, const SyncManifest &manifest);
+  QString manifestPath(const QString &folder);
+  const QByteArray & entryHash(const QString &folder, SyncEntry &entry, const QString &relativePath);
+  bool isSame(SyncEntry &entry1, SyncEntry &entry2, const QString &relativePath);
+  void createDir(const QString &folder, const QString &relativePath, SyncManifest &manifest);
+  void addCopy(const QString &source, const QString &destination, const QString &relativePath, const SyncEntry &sourceEntry, SyncManifest &destinationManifest);
+  void copyFile(CopyJob &job);
+  void addError(const QString &error);
+
   QString folder1;
   QString folder2;
   ProgressWidget *progress;
   QStringList errors;
-  bool simulation;
-  int index;
+  SyncManifest manifest1;
+  SyncManifest manifest2;
+  QList<CopyJob> jobs;
+  QMutex mutex;
+  QAtomicInt filesDone;
+  qint64 bytesDone;
 };
 
 #endif /* SYNCPROCESS_H_ */
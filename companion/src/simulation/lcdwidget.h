@@ -18,6 +18,7 @@
 #define lcd_widget_h
 
 #include <QWidget>
+#include <QImage>
 #include "appdata.h"
 
 class lcdWidget : public QWidget {
@@ -26,7 +27,8 @@ class lcdWidget : public QWidget {
       QWidget(parent),
       lcdBuf(NULL),
       previousBuf(NULL),
-      lightEnable(false)
+      lightEnable(false),
+      _r(0), _g(0), _b(0)
     {
     }
 
@@ -45,6 +47,11 @@ class lcdWidget : public QWidget {
       lcdSize = (width * ((height+7)/8)) * depth;
       previousBuf = (unsigned char *)malloc(lcdSize);
       memset(previousBuf, 0, lcdSize);
+      image = QImage(width, height, QImage::Format_Indexed8);
+      updatePalette();
+      for (int y=0; y<lcdHeight; y++) {
+        unpackRow(y);
+      }
     }
 
     void setBackgroundColor(int red, int green, int blue)
@@ -52,13 +59,14 @@ class lcdWidget : public QWidget {
       _r = red;
       _g = green;
       _b = blue;
+      updatePalette();
     }
 
     void makeScreenshot(const QString & fileName)
     {
       QPixmap buffer(2*lcdWidth, 2*lcdHeight);
       QPainter p(&buffer);
-      doPaint(p);
+      doPaint(p, 2);
       bool toclipboard = g.snapToClpbrd();
       if (toclipboard) {
         QApplication::clipboard()->setPixmap( buffer );
@@ -76,11 +84,24 @@ class lcdWidget : public QWidget {
 
     void onLcdChanged(bool light)
     {
-      if (light != lightEnable || memcmp(previousBuf, lcdBuf, lcdSize)) {
+      if (light != lightEnable) {
         lightEnable = light;
-        memcpy(previousBuf, lcdBuf, lcdSize);
+        updatePalette();
         update();
       }
+
+      // lcd_buf is made of rows of bytes, each one holding 8/depth lines
+      int linesPerRow = 8 / lcdDepth;
+      for (int offset=0, y=0; offset<lcdSize; offset+=lcdWidth, y+=linesPerRow) {
+        if (memcmp(&previousBuf[offset], &lcdBuf[offset], lcdWidth)) {
+          memcpy(&previousBuf[offset], &lcdBuf[offset], lcdWidth);
+          for (int line=y; line<y+linesPerRow && line<lcdHeight; line++) {
+            unpackRow(line);
+          }
+          int scale = getScale();
+          update(0, scale*y, scale*lcdWidth, scale*linesPerRow);
+        }
+      }
     }
 
     virtual void mousePressEvent(QMouseEvent * event)
@@ -102,60 +123,64 @@ class lcdWidget : public QWidget {
     bool lightEnable;
     int _r, _g, _b;
 
-    inline void doPaint(QPainter & p)
+    QImage image; // one byte per pixel, the greyscale level (0-15) is the palette index
+
+    void updatePalette()
     {
-      QRgb rgb;
+      QVector<QRgb> palette(16);
+      for (int z=0; z<16; z++) {
+        if (lightEnable)
+          palette[z] = qRgb(_r-(z*_r)/15, _g-(z*_g)/15, _b-(z*_b)/15);
+        else
+          palette[z] = qRgb(161-(z*161)/15, 161-(z*161)/15, 161-(z*161)/15);
+      }
+      image.setColorTable(palette);
+    }
 
-      if (lightEnable)
-        rgb = qRgb(_r, _g, _b);
-      else
-        rgb = qRgb(161, 161, 161);
+    void unpackRow(int y)
+    {
+      uchar * line = image.scanLine(y);
+      const unsigned char * src = previousBuf + (y*lcdDepth/8)*lcdWidth;
+      if (lcdDepth == 1) {
+        unsigned int mask = (1 << (y%8));
+        for (int x=0; x<lcdWidth; x++) {
+          line[x] = (src[x] & mask) ? 15 : 0;
+        }
+      }
+      else if (y & 1) {
+        for (int x=0; x<lcdWidth; x++) {
+          line[x] = src[x] >> 4;
+        }
+      }
+      else {
+        for (int x=0; x<lcdWidth; x++) {
+          line[x] = src[x] & 0x0F;
+        }
+      }
+    }
 
-      p.setBackground(QBrush(rgb));
-      p.eraseRect(0, 0, 2*lcdWidth, 2*lcdHeight);
+    // the LCD is drawn at 2x, or more if the widget is larger
+    inline int getScale()
+    {
+      if (lcdWidth <= 0 || lcdHeight <= 0)
+        return 2;
+      return qMax(2, qMin(width() / lcdWidth, height() / lcdHeight));
+    }
 
+    inline void doPaint(QPainter & p, int scale)
+    {
       if (lcdBuf) {
-        if (lcdDepth == 1) {
-          rgb = qRgb(0, 0, 0);
-          p.setPen(rgb);
-          p.setBrush(QBrush(rgb));
-        }
-
-        unsigned int previousDepth = 0xFF;
-
-        for (int y=0; y<lcdHeight; y++) {
-          unsigned int idx = (y*lcdDepth/8)*lcdWidth;
-          unsigned int mask = (1 << (y%8));
-          for (int x=0; x<lcdWidth; x++, idx++) {
-            if (lcdDepth == 1) {
-              if (lcdBuf[idx] & mask) {
-                p.drawRect(2*x, 2*y, 1, 1);
-              }
-            }
-            else {
-              unsigned int z = (y & 1) ? (lcdBuf[idx] >> 4) : (lcdBuf[idx] & 0x0F);
-              if (z) {
-                if (z != previousDepth) {
-                  previousDepth = z;
-                  if (lightEnable)
-                    rgb = qRgb(_r-(z*_r)/15, _g-(z*_g)/15, _b-(z*_b)/15);
-                  else
-                    rgb = qRgb(161-(z*161)/15, 161-(z*161)/15, 161-(z*161)/15);
-                  p.setPen(rgb);
-                  p.setBrush(QBrush(rgb));
-                }
-                p.drawRect(2*x, 2*y, 1, 1);
-              }
-            }
-          }
-        }
+        p.drawImage(QRect(0, 0, scale*lcdWidth, scale*lcdHeight), image);
+      }
+      else {
+        p.fillRect(0, 0, scale*lcdWidth, scale*lcdHeight, lightEnable ? QColor(_r, _g, _b) : QColor(161, 161, 161));
       }
     }
 
     void paintEvent(QPaintEvent*)
     {
       QPainter p(this);
-      doPaint(p);
+      doPaint(p, getScale());
     }
 
 };
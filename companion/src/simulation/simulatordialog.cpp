@@ -54,6 +54,7 @@ SimulatorDialog::SimulatorDialog(QWidget * parent, unsigned int flags):
   lightOn(false),
   simulator(NULL),
   lastPhase(-1),
+  speed(1),
   beepVal(0),
   TelemetrySimu(0),
   TrainerSimu(0),
@@ -67,6 +68,9 @@ SimulatorDialog::SimulatorDialog(QWidget * parent, unsigned int flags):
   new QShortcut(QKeySequence(Qt::Key_F4), this, SLOT(openTelemetrySimulator()));
   new QShortcut(QKeySequence(Qt::Key_F5), this, SLOT(openTrainerSimulator()));
   new QShortcut(QKeySequence(Qt::Key_F6), this, SLOT(openDebugOutput()));
+  new QShortcut(QKeySequence(Qt::Key_F7), this, SLOT(changeSpeed()));
+  new QShortcut(QKeySequence(Qt::Key_F8), this, SLOT(saveSnapshot()));
+  new QShortcut(QKeySequence(Qt::Key_F9), this, SLOT(restoreSnapshot()));
   traceCallbackInstance = this;
 }
 
@@ -605,6 +609,39 @@ void SimulatorDialog9X::updateBeepButton()
   }
 }
 
+void SimulatorDialog::changeSpeed()
+{
+  // 1x, 2x, 10x, as fast as possible
+  switch (speed) {
+    case 1:
+      speed = 2;
+      break;
+    case 2:
+      speed = 10;
+      break;
+    case 10:
+      speed = 0;
+      break;
+    default:
+      speed = 1;
+      break;
+  }
+  simulator->setSpeed(speed);
+}
+
+void SimulatorDialog::saveSnapshot()
+{
+  simulator->saveState(snapshot);
+}
+
+void SimulatorDialog::restoreSnapshot()
+{
+  // rewind to the last snapshot
+  if (!snapshot.isEmpty()) {
+    simulator->restoreState(snapshot);
+  }
+}
+
 void SimulatorDialog::onTimerEvent()
 {
   static unsigned int lcd_counter = 0;
@@ -619,6 +656,8 @@ void SimulatorDialog::onTimerEvent()
   if (tabWidget->currentIndex()==0) {
     bool lightEnable;
     if (simulator->lcdChanged(lightEnable)) {
+      // the firmware may have rendered several frames since the last tick
+      while (simulator->lcdChanged(lightEnable));
       lcd->onLcdChanged(lightEnable);
       if (lightOn != lightEnable) {
         setLightOn(lightEnable);
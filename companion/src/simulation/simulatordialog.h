@@ -79,6 +79,8 @@ class SimulatorDialog : public QDialog
 
     SimulatorInterface *simulator;
     unsigned int lastPhase;
+    unsigned int speed;
+    QByteArray snapshot;
 
     void setupSticks();
     void setupTimer();
@@ -135,6 +137,9 @@ class SimulatorDialog : public QDialog
     void on_trimHRight_valueChanged(int);
     void on_trimVRight_valueChanged(int);
     void onTimerEvent();
+    void changeSpeed();
+    void saveSnapshot();
+    void restoreSnapshot();
     void onTrimPressed();
     void onTrimReleased();
     void openTelemetrySimulator();
@@ -79,6 +79,9 @@ for (int fm=0; fm<MAX_FLIGHT_MODES; fm++) {
 
 #ifdef LCDCHANGED_IMPORT
 #undef LCDCHANGED_IMPORT
+#if defined(SIMU_VIRTUAL_CLOCK)
+return simuPopFrame(lightEnable);
+#else
 if (lcd_refresh) {
   lightEnable = IS_BACKLIGHT_ON();
   lcd_refresh = false;
@@ -86,12 +89,34 @@ if (lcd_refresh) {
 }
 return false;
 #endif
+#endif
 
 #ifdef TIMER10MS_IMPORT
 #undef TIMER10MS_IMPORT
 if (!main_thread_running)
   return false;
+#if !defined(SIMU_VIRTUAL_CLOCK)
 per10ms();
+#endif
+return true;
+#endif
+
+#ifdef SETSPEED_IMPORT
+#undef SETSPEED_IMPORT
+simu_speed = speed;
+#endif
+
+#ifdef SAVESTATE_IMPORT
+#undef SAVESTATE_IMPORT
+state.resize(simuStateSize());
+simuSaveState((::uint8_t *)state.data());
+#endif
+
+#ifdef RESTORESTATE_IMPORT
+#undef RESTORESTATE_IMPORT
+if ((unsigned int)state.size() != simuStateSize())
+  return false;
+simuRestoreState((const ::uint8_t *)state.constData());
 return true;
 #endif
 
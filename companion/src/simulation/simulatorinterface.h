@@ -60,6 +60,12 @@ class SimulatorInterface {
 
     virtual bool timer10ms() = 0;
 
+    virtual void setSpeed(unsigned int speed) = 0; /* 0 = as fast as possible */
+
+    virtual void saveState(QByteArray & state) = 0;
+
+    virtual bool restoreState(const QByteArray & state) = 0;
+
     virtual uint8_t * getLcd() = 0;
 
     virtual bool lcdChanged(bool & lightEnable) = 0;
@@ -2,10 +2,51 @@
 #include "ui_splashlibrary.h"
 #include "appdata.h"
 #include <QtGui>
+#include <QtConcurrentMap>
+#include <QCryptographicHash>
 #include "helpers.h"
 #include "firmwareinterface.h"
 #include "helpers.h"
 
+// Decodes and converts a library image, the converted image of a library
+// file is cached on disk, keyed by its path, mtime and the firmware type
+class SplashThumbnail
+{
+  public:
+    typedef QImage result_type;
+
+    SplashThumbnail(const QString & firmwareType):
+      firmwareType(firmwareType)
+    {
+    }
+
+    QImage operator()(const QString & fileName) const
+    {
+      // images embedded in the resources are cheap to convert
+      if (fileName.startsWith(":")) {
+        return makeSplashImage(QImage(fileName), firmwareType);
+      }
+
+      QString key = fileName + "|" + QFileInfo(fileName).lastModified().toString(Qt::ISODate) + "|" + firmwareType;
+      QString cacheDir = QDesktopServices::storageLocation(QDesktopServices::CacheLocation) + "/splashes";
+      QString cacheFile = cacheDir + "/" + QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5).toHex() + ".png";
+      QImage image(cacheFile);
+      if (image.isNull()) {
+        image = QImage(fileName);
+        if (image.isNull()) {
+          return image;
+        }
+        image = makeSplashImage(image, firmwareType);
+        QDir().mkpath(cacheDir);
+        image.save(cacheFile, "png");
+      }
+      return image;
+    }
+
+  protected:
+    QString firmwareType;
+};
+
 splashLibrary::splashLibrary(QWidget *parent, QString * fileName) : QDialog(parent), ui(new Ui::splashLibrary) {
   splashFileName = fileName;
   ui->setupUi(this);
@@ -13,6 +54,12 @@ splashLibrary::splashLibrary(QWidget *parent, QString * fileName) : QDialog(pare
   ui->nextPage->setIcon(CompanionIcon("arrow-right.png"));
   ui->prevPage->setIcon(CompanionIcon("arrow-left.png"));
   page = 0;
+  labels << ui->FwImage_01 << ui->FwImage_02 << ui->FwImage_03 << ui->FwImage_04
+         << ui->FwImage_05 << ui->FwImage_06 << ui->FwImage_07 << ui->FwImage_08
+         << ui->FwImage_09 << ui->FwImage_10 << ui->FwImage_11 << ui->FwImage_12
+         << ui->FwImage_13 << ui->FwImage_14 << ui->FwImage_15 << ui->FwImage_16
+         << ui->FwImage_17 << ui->FwImage_18 << ui->FwImage_19 << ui->FwImage_20;
+  connect(&thumbnails, SIGNAL(resultReadyAt(int)), this, SLOT(onThumbnailReady(int)));
   getFileList();
   if (imageList.size() > 20) {
     ui->nextPage->setEnabled(true);
@@ -25,41 +72,39 @@ splashLibrary::splashLibrary(QWidget *parent, QString * fileName) : QDialog(pare
 }
 
 splashLibrary::~splashLibrary() {
+  thumbnails.cancel();
+  thumbnails.waitForFinished();
   delete ui;
 }
 
 void splashLibrary::setupPage(int page) {
-  splashLabel * sl[] = { ui->FwImage_01, ui->FwImage_02, ui->FwImage_03, ui->FwImage_04 ,
-        ui->FwImage_05, ui->FwImage_06, ui->FwImage_07, ui->FwImage_08 ,
-        ui->FwImage_09, ui->FwImage_10, ui->FwImage_11, ui->FwImage_12 ,
-        ui->FwImage_13, ui->FwImage_14, ui->FwImage_15, ui->FwImage_16 ,
-        ui->FwImage_17, ui->FwImage_18, ui->FwImage_19, ui->FwImage_20 };
+  thumbnails.cancel();
+  thumbnails.waitForFinished();
+  QStringList fileNames;
   for(int i=0; i<20; i++) {
+    labels[i]->clear();
+    labels[i]->setDisabled(true);
+    labels[i]->setStyleSheet("border:1px;");
+    labels[i]->setId(-1);
     if ((i + 20 * page) < imageList.size()) {
-      QImage image(imageList.at(i + 20 * page));
-      if (!image.isNull()) {
-        sl[i]->setPixmap(makePixMap(image, g.profile[g.id()].fwType()));
-        sl[i]->setEnabled(true);
-        sl[i]->setId((i + 20 * page));
-        sl[i]->setStyleSheet("border:1px solid; border-color:#999999;");
-      }
-      else {
-        sl[i]->clear();
-        sl[i]->setDisabled(true);
-        sl[i]->setStyleSheet("border:1px;");
-        sl[i]->setId(-1);
-      }
-    }
-    else {
-      sl[i]->clear();
-      sl[i]->setDisabled(true);
-      sl[i]->setStyleSheet("border:1px;");
-      sl[i]->setId(-1);
+      fileNames << imageList.at(i + 20 * page);
     }
   }
+  // the labels are filled as soon as their image has been converted
+  thumbnails.setFuture(QtConcurrent::mapped(fileNames, SplashThumbnail(g.profile[g.id()].fwType())));
   setWindowTitle(tr("Splash Library - page %1 of %2").arg(page + 1).arg(ceil((float) imageList.size() / 20.0)));
 }
 
+void splashLibrary::onThumbnailReady(int index) {
+  QImage image = thumbnails.resultAt(index);
+  if (!image.isNull()) {
+    labels[index]->setPixmap(QPixmap::fromImage(image));
+    labels[index]->setEnabled(true);
+    labels[index]->setId((index + 20 * page));
+    labels[index]->setStyleSheet("border:1px solid; border-color:#999999;");
+  }
+}
+
 void splashLibrary::getFileList() {
   imageList.clear();
   if (g.embedSplashes()) {
@@ -83,8 +128,8 @@ void splashLibrary::getFileList() {
       for (int i = 0; i < tmp.size(); i++) {
         QFileInfo fileInfo = tmp.at(i);
         QString filename = libraryPath + "/" + fileInfo.fileName();
-        QImage image(filename);
-        if (!image.isNull()) {
+        // only the header is read here, the images are decoded page by page
+        if (QImageReader(filename).canRead()) {
           imageList.append(filename);
         }
         else {
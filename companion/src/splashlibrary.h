@@ -3,11 +3,14 @@
 
 #include <QtGui>
 #include <QDialog>
+#include <QFutureWatcher>
 
 namespace Ui {
     class splashLibrary;
 }
 
+class splashLabel;
+
 class splashLibrary : public QDialog
 {
     Q_OBJECT
@@ -21,11 +24,14 @@ private slots:
     void onButtonPressed(int button);
     void on_nextPage_clicked();
     void on_prevPage_clicked();
+    void onThumbnailReady(int index);
  
 private:
     void getFileList();
     void setupPage(int page);
     Ui::splashLibrary *ui;
+    QList<splashLabel *> labels;
+    QFutureWatcher<QImage> thumbnails;
     QString * splashFileName;
     QString libraryPath;
     QStringList imageList;
@@ -0,0 +1,109 @@
+/*
+ * Author - Bertrand Songis <bsongis@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <QtTest>
+#include "hextest.h"
+#include "hexinterface.h"
+#include "firmwareinterface.h"
+
+// 3 bytes at 0x30, 2 bytes at 0x33, then the end of file record
+#define HEX_RECORD1  ":0300300002337A1E"
+#define HEX_RECORD2  ":02003300ABCD53"
+#define HEX_EOF      ":00000001FF"
+#define HEX_SIZE     0x35
+
+static int parse(const char *hex, uint8_t *data, int maxsize)
+{
+  return HexInterface::parse((const uint8_t *)hex, strlen(hex), data, maxsize);
+}
+
+static void checkData(const uint8_t *data)
+{
+  QCOMPARE(data[0x2F], (uint8_t)0x00);
+  QCOMPARE(data[0x30], (uint8_t)0x02);
+  QCOMPARE(data[0x31], (uint8_t)0x33);
+  QCOMPARE(data[0x32], (uint8_t)0x7A);
+  QCOMPARE(data[0x33], (uint8_t)0xAB);
+  QCOMPARE(data[0x34], (uint8_t)0xCD);
+}
+
+void HexTest::validRecords()
+{
+  uint8_t data[256] = { 0 };
+  QCOMPARE(parse(HEX_RECORD1 "\n" HEX_RECORD2 "\n" HEX_EOF "\n", data, sizeof(data)), HEX_SIZE);
+  checkData(data);
+
+  // the last line may have no line ending, lowercase digits are accepted
+  memset(data, 0, sizeof(data));
+  QCOMPARE(parse(HEX_RECORD1 "\n:02003300abcd53", data, sizeof(data)), HEX_SIZE);
+  checkData(data);
+}
+
+void HexTest::badChecksum()
+{
+  uint8_t data[256] = { 0 };
+  QCOMPARE(parse(HEX_RECORD1 "\n:02003300ABCD54\n" HEX_EOF "\n", data, sizeof(data)), 0);
+  QCOMPARE(parse(":0300300002337A1G\n", data, sizeof(data)), 0);
+}
+
+void HexTest::crlfLineEndings()
+{
+  uint8_t data[256] = { 0 };
+  QCOMPARE(parse(HEX_RECORD1 "\r\n" HEX_RECORD2 "\r\n" HEX_EOF "\r\n", data, sizeof(data)), HEX_SIZE);
+  checkData(data);
+
+  // through a text stream too
+  QString text(HEX_RECORD1 "\r\n" HEX_RECORD2 "\r\n" HEX_EOF "\r\n");
+  QTextStream stream(&text);
+  memset(data, 0, sizeof(data));
+  QCOMPARE(HexInterface(stream).load(data, sizeof(data)), HEX_SIZE);
+  checkData(data);
+}
+
+void HexTest::shortLine()
+{
+  uint8_t data[256] = { 0 };
+  QCOMPARE(parse(HEX_RECORD1 "\n:03003000\n", data, sizeof(data)), 0);
+  QCOMPARE(parse(":0300300002337A\n", data, sizeof(data)), 0); // checksum missing
+}
+
+void HexTest::recordPastMaxSize()
+{
+  uint8_t data[HEX_SIZE] = { 0 };
+  QCOMPARE(parse(HEX_RECORD1 "\n" HEX_RECORD2 "\n", data, HEX_SIZE), HEX_SIZE);
+  QCOMPARE(parse(HEX_RECORD1 "\n" HEX_RECORD2 "\n", data, HEX_SIZE-1), 0);
+}
+
+void HexTest::crc()
+{
+  QCOMPARE(crc32((const uint8_t *)"123456789", 9), (quint32)0xCBF43926);
+  QCOMPARE(crc32(NULL, 0), (quint32)0);
+}
+
+void HexTest::firmwareCrc()
+{
+  QTemporaryFile file(QDir::tempPath() + "/firmwareXXXXXX.hex");
+  QVERIFY(file.open());
+  file.write(HEX_RECORD1 "\r\n" HEX_RECORD2 "\r\n" HEX_EOF "\r\n");
+  file.flush();
+
+  FirmwareInterface firmware(file.fileName());
+  QCOMPARE(firmware.getSize(), HEX_SIZE);
+
+  uint8_t data[HEX_SIZE] = { 0 };
+  parse(HEX_RECORD1 "\n" HEX_RECORD2 "\n", data, HEX_SIZE);
+  QCOMPARE(firmware.getCrc(), crc32(data, HEX_SIZE));
+}
+
+QTEST_APPLESS_MAIN(HexTest)
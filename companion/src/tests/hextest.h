@@ -0,0 +1,34 @@
+/*
+ * Author - Bertrand Songis <bsongis@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef hextest_h
+#define hextest_h
+
+#include <QObject>
+
+class HexTest: public QObject
+{
+  Q_OBJECT
+
+  private slots:
+    void validRecords();
+    void badChecksum();
+    void crlfLineEndings();
+    void shortLine();
+    void recordPastMaxSize();
+    void crc();
+    void firmwareCrc();
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * Author - Bertrand Songis <bsongis@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "importexport.h"
+#include "firmwares/opentx/opentxeeprom.h"
+
+#define FIRST_VERSION 212
+#define LAST_VERSION  217
+#define SEEDS         3
+
+ImportExportCase::ImportExportCase(Firmware * firmware, unsigned int version, unsigned int variant, bool model, int seed):
+  firmware(firmware),
+  version(version),
+  variant(variant),
+  model(model),
+  seed(seed)
+{
+}
+
+QString ImportExportCase::getName() const
+{
+  return QString("%1 v%2 variant %3 %4 seed %5").arg(firmware->getId()).arg(version).arg(variant).arg(model ? "model" : "general").arg(seed);
+}
+
+void ImportExportCase::fillGeneral(GeneralSettings & settings) const
+{
+  for (int i=0; i<NUM_STICKS+C9X_NUM_POTS; i++) {
+    settings.calibMid[i] = 0x200 + seed*7 - i*3;
+    settings.calibSpanNeg[i] = 0x180 - seed*5 + i;
+    settings.calibSpanPos[i] = 0x180 + seed*3 + i*2;
+  }
+  settings.currModel = seed % 16;
+  settings.contrast = 20 + seed;
+  settings.vBatWarn = 80 + seed;
+  settings.vBatCalib = seed*2 - 3;
+  settings.backlightMode = seed % 5;
+  settings.stickMode = seed % 4;
+  settings.beeperMode = (seed & 1) ? GeneralSettings::BEEPER_ALL : GeneralSettings::BEEPER_ALARMS_ONLY;
+  settings.disableThrottleWarning = seed & 1;
+  settings.disableMemoryWarning = seed & 2;
+}
+
+void ImportExportCase::fillModel(ModelData & model, const GeneralSettings & settings) const
+{
+  model.setDefaultValues(seed, settings);
+  model.extendedLimits = seed & 1;
+  model.extendedTrims = seed & 2;
+  model.thrTrim = seed & 1;
+  model.trimInc = seed % 5;
+  model.beepANACenter = (seed * 37) % 128;
+  for (int i=0; i<C9X_MAX_TIMERS; i++) {
+    model.timers[i].val = seed*60 + i*15;
+    model.timers[i].minuteBeep = (seed + i) & 1;
+    model.timers[i].countdownBeep = (seed + i) % 3;
+    model.timers[i].persistent = i % 2;
+  }
+  for (int i=0; i<C9X_MAX_FLIGHT_MODES; i++) {
+    for (int j=0; j<NUM_STICKS; j++) {
+      model.flightModeData[i].trim[j] = ((seed*31 + i*13 + j*7) % 250) - 125;
+    }
+  }
+  for (int i=0; i<C9X_MAX_MIXERS; i++) {
+    if (model.mixData[i].destCh) {
+      model.mixData[i].weight = 100 - (seed*11 + i) % 150;
+      model.mixData[i].sOffset = (seed*3 + i) % 40 - 20;
+    }
+  }
+  for (int i=0; i<C9X_MAX_EXPOS; i++) {
+    if (model.expoData[i].mode) {
+      model.expoData[i].weight = 100 - (seed*7 + i) % 100;
+    }
+  }
+  for (int i=0; i<C9X_NUM_CHNOUT; i++) {
+    model.limitData[i].min = -1000 + (seed*10 + i*5) % 200;
+    model.limitData[i].max = 1000 - (seed*20 + i*5) % 200;
+    model.limitData[i].offset = (seed*37 + i*11) % 200 - 100;
+    model.limitData[i].ppmCenter = (seed + i) % 20 - 10;
+    model.limitData[i].revert = (seed + i) & 1;
+  }
+}
+
+QByteArray ImportExportCase::exportData() const
+{
+  current_firmware_variant = firmware;
+  GeneralSettings settings;
+  fillGeneral(settings);
+  QByteArray result;
+  if (model) {
+    ModelData modelData;
+    fillModel(modelData, settings);
+    OpenTxModelData(modelData, firmware->getBoard(), version, variant).Export(result);
+  }
+  else {
+    OpenTxGeneralData(settings, firmware->getBoard(), version, variant).Export(result);
+  }
+  return result;
+}
+
+QByteArray ImportExportCase::reimportData(const QByteArray & data) const
+{
+  current_firmware_variant = firmware;
+  QByteArray input = data;
+  QByteArray result;
+  if (model) {
+    ModelData modelData;
+    OpenTxModelData(modelData, firmware->getBoard(), version, variant).Import(input);
+    OpenTxModelData(modelData, firmware->getBoard(), version, variant).Export(result);
+  }
+  else {
+    GeneralSettings settings;
+    OpenTxGeneralData(settings, firmware->getBoard(), version, variant).Import(input);
+    OpenTxGeneralData(settings, firmware->getBoard(), version, variant).Export(result);
+  }
+  return result;
+}
+
+QList<ImportExportCase> importExportCases()
+{
+  static const unsigned int stockVariants[] = { 0, GVARS_VARIANT, FRSKY_VARIANT, GVARS_VARIANT|FRSKY_VARIANT, POS3_VARIANT, MAVLINK_VARIANT, GVARS_VARIANT|FRSKY_VARIANT|POS3_VARIANT };
+
+  if (firmwares.isEmpty()) {
+    registerOpenTxFirmwares();
+  }
+
+  QList<ImportExportCase> result;
+  foreach(Firmware * firmware, firmwares) {
+    BoardEnum board = firmware->getBoard();
+    for (unsigned int version=FIRST_VERSION; version<=LAST_VERSION; version++) {
+      // Sky9x models were converted by the older format classes in 212
+      if (version == 212 && IS_SKY9X(board))
+        continue;
+      for (unsigned int i=0; i<(IS_9X(board) ? DIM(stockVariants) : 1); i++) {
+        unsigned int variant = stockVariants[i] | (board == BOARD_M128 ? M128_VARIANT : 0);
+        for (int seed=0; seed<SEEDS; seed++) {
+          result << ImportExportCase(firmware, version, variant, false, seed);
+          result << ImportExportCase(firmware, version, variant, true, seed);
+        }
+      }
+    }
+  }
+  return result;
+}
@@ -0,0 +1,53 @@
+/*
+ * Author - Bertrand Songis <bsongis@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef importexport_h
+#define importexport_h
+
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include "eeprominterface.h"
+
+/*
+ * One OpenTxGeneralData or OpenTxModelData export, for a board, an EEPROM
+ * version and a variant. The same cases are compiled against the current
+ * fields serialization and against the reference one (tests/reference).
+ */
+class ImportExportCase {
+  public:
+    ImportExportCase(Firmware * firmware, unsigned int version, unsigned int variant, bool model, int seed);
+
+    QString getName() const;
+
+    // the data filled from seed, exported
+    QByteArray exportData() const;
+
+    // data imported, then exported again
+    QByteArray reimportData(const QByteArray & data) const;
+
+  protected:
+    void fillGeneral(GeneralSettings & settings) const;
+    void fillModel(ModelData & model, const GeneralSettings & settings) const;
+
+    Firmware * firmware;
+    unsigned int version;
+    unsigned int variant;
+    bool model;
+    int seed;
+};
+
+QList<ImportExportCase> importExportCases();
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Author - Bertrand Songis <bsongis@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <QtTest>
+#include "importexporttest.h"
+#include "importexport.h"
+
+// written by importexportreference, built with the QBitArray fields serialization
+static QString referencePath;
+
+void ImportExportTest::sameBytesAsReference()
+{
+  QFile file(referencePath);
+  QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(referencePath));
+  QDataStream stream(&file);
+
+  foreach(const ImportExportCase & test, importExportCases()) {
+    QString name;
+    QByteArray reference;
+    stream >> name >> reference;
+    QCOMPARE(name, test.getName());
+    QVERIFY2(test.exportData() == reference, qPrintable(name));
+  }
+  QVERIFY(stream.atEnd());
+}
+
+void ImportExportTest::reimport()
+{
+  foreach(const ImportExportCase & test, importExportCases()) {
+    QByteArray data = test.exportData();
+    QVERIFY2(test.reimportData(data) == data, qPrintable(test.getName()));
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2) {
+    printf("usage: %s reference [test options]\n", argv[0]);
+    return 1;
+  }
+  referencePath = argv[1];
+  argv[1] = argv[0];
+
+  ImportExportTest test;
+  return QTest::qExec(&test, argc-1, argv+1);
+}
@@ -0,0 +1,42 @@
+/*
+ * Author - Bertrand Songis <bsongis@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <QFile>
+#include <QDataStream>
+#include "importexport.h"
+
+/*
+ * Writes the exports of all the cases, serialized through QBitArray, for
+ * importexporttest to compare
+ */
+int main(int argc, char *argv[])
+{
+  if (argc != 2) {
+    printf("usage: %s reference\n", argv[0]);
+    return 1;
+  }
+
+  QFile file(argv[1]);
+  if (!file.open(QIODevice::WriteOnly)) {
+    printf("cannot write %s\n", argv[1]);
+    return 1;
+  }
+
+  QDataStream stream(&file);
+  foreach(const ImportExportCase & test, importExportCases()) {
+    stream << test.getName() << test.exportData();
+  }
+  return 0;
+}
@@ -67,10 +67,7 @@ void debugPuts(const char *format, ...)
     traceCallback(tmp);
   }
 #else
-  const char *t = tmp;
-  while (*t) {
-    debugPutc(*t++);
-  }
+  debugWrite(tmp, strlen(tmp));
 #endif
 }
 
@@ -74,9 +74,19 @@ uint8_t *Eeprom32_buffer_address ;
 uint8_t *Eeprom32_source_address ;
 uint32_t Eeprom32_address ;
 uint32_t Eeprom32_data_size ;
+uint32_t Eeprom32_journal_size ;
+uint8_t Eeprom32_shadow_file = 0xFF ;     // file whose content is in Eeprom_buffer
 
 #define EE_NOWAIT	1
 
+// Journal of the changes written after an image, when they don't fit in
+// EE32_JOURNAL_MAX bytes or in the block a full image is written instead
+#define EE32_JOURNAL_MAX  128
+// Trailing zeroes of an image are not written, leaving room for the journal
+#define EE32_TRIM_MIN     512
+
+uint8_t Eeprom32_journal[EE32_JOURNAL_MAX] ;
+
 uint32_t get_current_block_number( uint32_t block_no, uint16_t *p_size, uint32_t *p_seq ) ;
 void write32_eeprom_block( uint32_t eeAddress, register uint8_t *buffer, uint32_t size, uint32_t immediate=0 ) ;
 
@@ -102,6 +112,13 @@ struct t_eeprom_buffer
     } data ;
 } Eeprom_buffer ;
 
+// Loads the content of a file in Eeprom_buffer, which then shadows it to diff the next saves
+void ee32_read_shadow(uint8_t index)
+{
+  File_system[index].journal = read32_eeprom_file(File_system[index].block_no, File_system[index].size, Eeprom_buffer.data.bytes, sizeof(Eeprom_buffer.data)) ;
+  Eeprom32_shadow_file = index ;
+}
+
 void eeDeleteModel(uint8_t id)
 {
   eeCheck(true);
@@ -120,7 +137,7 @@ bool eeCopyModel(uint8_t dst, uint8_t src)
   // eeCheck(true) should have been called before entering here
 
   uint16_t size = File_system[src+1].size ;
-  read32_eeprom_data( (File_system[src+1].block_no << 12) + sizeof( struct t_eeprom_header), ( uint8_t *)&Eeprom_buffer.data.model_data, size) ;
+  ee32_read_shadow(src+1) ;
 
   if (size > sizeof(g_model.header.name))
     memcpy(modelHeaders[dst].name, Eeprom_buffer.data.model_data.header.name, sizeof(g_model.header.name));
@@ -147,9 +164,11 @@ void eeSwapModels(uint8_t id1, uint8_t id2)
   // block_no(id1) has been shifted now, but we have the size
 
   // TODO flash saving with function above ...
+  Eeprom32_shadow_file = 0xFF ;
   if (id2_size > sizeof(g_model.header.name)) {
-    read32_eeprom_data( (id2_block_no << 12) + sizeof( struct t_eeprom_header), ( uint8_t *)&Eeprom_buffer.data.model_data, id2_size);
+    read32_eeprom_file(id2_block_no, id2_size, Eeprom_buffer.data.bytes, sizeof(Eeprom_buffer.data));
     memcpy(modelHeaders[id1].name, Eeprom_buffer.data.model_data.header.name, sizeof(g_model.header.name));
+    id2_size = sizeof(g_model) ;
   }
   else {
     memset(modelHeaders[id1].name, 0, sizeof(g_model.header.name));
@@ -236,6 +255,52 @@ uint8_t byte_checksum( uint8_t *p, uint32_t size )
 	return csum ;
 }
 
+// Reads the image of a file and replays its journal over it, the buffer is
+// zero-filled up to length. Returns the end of the journal in the block, or
+// the block size when it is damaged or not flagged and a full image has to be written
+uint32_t read32_eeprom_file(uint32_t block_no, uint16_t size, uint8_t *buffer, uint32_t length)
+{
+  uint32_t eeAddress = block_no << 12 ;
+  uint32_t offset = sizeof(struct t_eeprom_header) + size ;
+
+  memset(buffer, 0, length) ;
+  if (size) {
+    struct t_eeprom_header header ;
+    read32_eeprom_data(eeAddress, (uint8_t *)&header, sizeof(header)) ;
+    read32_eeprom_data(eeAddress + sizeof(struct t_eeprom_header), buffer, min<uint32_t>(size, length)) ;
+    if (!(header.flags & EE32_FLAG_JOURNAL)) {
+      return 4096 ;
+    }
+  }
+
+  while (offset + sizeof(struct t_journal_record) <= 4096) {
+    struct t_journal_record record ;
+    uint8_t chunk[16] ;
+    read32_eeprom_data(eeAddress + offset, (uint8_t *)&record, sizeof(record)) ;
+    if (record.offset == 0xFFFF && record.size == 0xFF && record.csum == 0xFF) {
+      return offset ;                     // erased, end of the journal
+    }
+    uint32_t end = offset + sizeof(record) + record.size ;
+    if (record.size == 0 || end > 4096 || record.offset + record.size > length) {
+      break ;
+    }
+    // the last record may have been cut by a power loss, check it before applying it
+    uint8_t csum = byte_checksum((uint8_t *)&record, 3) ;
+    for (uint32_t x = 0 ; x < record.size ; x += sizeof(chunk)) {
+      uint32_t count = min<uint32_t>(sizeof(chunk), record.size - x) ;
+      read32_eeprom_data(eeAddress + offset + sizeof(record) + x, chunk, count) ;
+      csum += byte_checksum(chunk, count) ;
+    }
+    if (csum != record.csum) {
+      break ;
+    }
+    read32_eeprom_data(eeAddress + offset + sizeof(record), buffer + record.offset, record.size) ;
+    offset = end ;
+  }
+
+  return 4096 ;
+}
+
 uint32_t ee32_check_header( struct t_eeprom_header *hptr )
 {
 	uint8_t csum ;
@@ -321,11 +386,7 @@ uint32_t get_current_block_number( uint32_t block_no, uint16_t *p_size, uint32_t
 // For conversions ...
 void loadGeneralSettings()
 {
-  memset(&g_eeGeneral, 0, sizeof(g_eeGeneral));
-  uint16_t size = min<int>(File_system[0].size, sizeof(g_eeGeneral));
-  if (size) {
-    read32_eeprom_data((File_system[0].block_no << 12) + sizeof(struct t_eeprom_header), (uint8_t *)&g_eeGeneral, size);
-  }
+  File_system[0].journal = read32_eeprom_file(File_system[0].block_no, File_system[0].size, (uint8_t *)&g_eeGeneral, sizeof(g_eeGeneral));
 }
 
 void loadModel(int index)
@@ -333,7 +394,7 @@ void loadModel(int index)
   memset(&g_model, 0, sizeof(g_model));
   int size = min<int>(File_system[index+1].size, sizeof(g_model));
   if (size > 256) { // if loaded a fair amount
-    read32_eeprom_data((File_system[index+1].block_no << 12) + sizeof(struct t_eeprom_header), (uint8_t *)&g_model, size) ;
+    File_system[index+1].journal = read32_eeprom_file(File_system[index+1].block_no, File_system[index+1].size, (uint8_t *)&g_model, sizeof(g_model)) ;
   }
 }
 
@@ -383,11 +444,11 @@ void eeLoadModel(uint8_t id)
       eeCheck(true);
     }
     else {
-      read32_eeprom_data((File_system[id+1].block_no << 12) + sizeof(struct t_eeprom_header), (uint8_t *)&g_model, size) ;
+      File_system[id+1].journal = read32_eeprom_file(File_system[id+1].block_no, File_system[id+1].size, (uint8_t *)&g_model, sizeof(g_model)) ;
     }
 
     AUDIO_FLUSH();
-    flightReset();
+    flightReset(true);
     logicalSwitchesReset();
 
     if (pulsesStarted()) {
@@ -421,6 +482,7 @@ bool eeModelExists(uint8_t id)
   return ( File_system[id+1].size > 0 ) ;
 }
 
+// The model header is never saved in the journal, it can be read from the image
 void eeLoadModelName(uint8_t id, char *name)
 {
   memclear(name, sizeof(g_model.header.name));
@@ -450,7 +512,9 @@ void fill_file_index()
   for (uint32_t i = 0 ; i < MAX_MODELS + 1 ; i += 1 )
   {
     File_system[i].block_no = get_current_block_number( i * 2, &File_system[i].size, &File_system[i].sequence_no ) ;
+    File_system[i].journal = 0 ;
   }
+  Eeprom32_shadow_file = 0xFF ;
 }
 
 void eeReadAll()
@@ -529,6 +593,101 @@ void eeCheck(bool immediately)
   }
 }
 
+#if defined(SIMU)
+void ee32_simu_erase(uint32_t eeAddress)
+{
+  static uint8_t erased[256] ;
+  memset(erased, 0xFF, sizeof(erased)) ;
+  for (uint32_t x = 0 ; x < 4096 ; x += sizeof(erased)) {
+    write32_eeprom_block(eeAddress + x, erased, sizeof(erased)) ;
+  }
+}
+#endif
+
+// Programs the journal bytes left, up to the next page boundary
+void ee32_journal_write()
+{
+  uint32_t size = 256 - (Eeprom32_address & 0xFF) ;
+  if (size > Eeprom32_journal_size) {
+    size = Eeprom32_journal_size ;
+  }
+  write32_eeprom_block(Eeprom32_address, Eeprom32_buffer_address, size, EE_NOWAIT) ;
+  Eeprom32_address += size ;
+  Eeprom32_buffer_address += size ;
+  Eeprom32_journal_size -= size ;
+  Eeprom32_process_state = E32_JOURNALSENDING ;
+}
+
+// Diffs the file being saved against its shadow and appends the changes to
+// its journal. Returns false when a full image has to be written instead
+bool ee32_journal_start()
+{
+  struct t_file_entry *file = &File_system[Eeprom32_file_index] ;
+  uint8_t *p = Eeprom32_source_address ;
+  uint8_t *q = Eeprom_buffer.data.bytes ;
+  uint32_t count = 0 ;
+
+  if (p == q || file->size == 0 || Eeprom32_data_size == 0) {
+    return false ;
+  }
+
+  if (Eeprom32_shadow_file != Eeprom32_file_index || file->journal == 0) {
+    ee32_read_shadow(Eeprom32_file_index) ;
+  }
+
+  for (uint32_t i = 0 ; i < Eeprom32_data_size ; ) {
+    if (p[i] == q[i]) {
+      i += 1 ;
+      continue ;
+    }
+    // changes closer than a record header go in the same record
+    uint32_t end = i + 1 ;
+    for (uint32_t j = end ; j < Eeprom32_data_size && j < end + sizeof(struct t_journal_record) && j < i + 255 ; j += 1) {
+      if (p[j] != q[j]) {
+        end = j + 1 ;
+      }
+    }
+    if (Eeprom32_file_index > 0 && i < sizeof(ModelHeader)) {
+      return false ;
+    }
+    struct t_journal_record record ;
+    uint8_t *data = &Eeprom32_journal[count + sizeof(record)] ;
+    record.offset = i ;
+    record.size = end - i ;
+    if (count + sizeof(record) + record.size > EE32_JOURNAL_MAX) {
+      return false ;
+    }
+    memcpy(data, &p[i], record.size) ;
+    record.csum = byte_checksum((uint8_t *)&record, 3) + byte_checksum(data, record.size) ;
+    memcpy(&Eeprom32_journal[count], &record, sizeof(record)) ;
+    count += sizeof(record) + record.size ;
+    i = end ;
+  }
+
+  if (count == 0) {
+    Eeprom32_process_state = E32_IDLE ;
+    return true ;
+  }
+
+  if (file->journal + count > 4096) {
+    return false ;                        // block full, compacted into a new image
+  }
+
+  for (uint32_t x = 0 ; x < count ; ) {
+    struct t_journal_record record ;
+    memcpy(&record, &Eeprom32_journal[x], sizeof(record)) ;
+    memcpy(&q[record.offset], &Eeprom32_journal[x + sizeof(record)], record.size) ;
+    x += sizeof(record) + record.size ;
+  }
+
+  Eeprom32_address = (file->block_no << 12) + file->journal ;
+  Eeprom32_buffer_address = Eeprom32_journal ;
+  Eeprom32_journal_size = count ;
+  file->journal += count ;
+  ee32_journal_write() ;
+  return true ;
+}
+
 void ee32_process()
 {
   register uint8_t *p ;
@@ -536,7 +695,7 @@ void ee32_process()
   register uint32_t x ;
   register uint32_t eeAddress ;
 
-  if ( Eeprom32_process_state == E32_BLANKCHECK ) {
+  if ( Eeprom32_process_state == E32_BLANKCHECK && !ee32_journal_start() ) {
     eeAddress = File_system[Eeprom32_file_index].block_no ^ 1 ;
     eeAddress <<= 12 ;		                                // Block start address
     Eeprom32_address = eeAddress ;				// Where to put new data
@@ -550,6 +709,7 @@ void ee32_process()
 
   if (Eeprom32_process_state == E32_READSENDING) {
 #ifdef SIMU
+    ee32_simu_erase(Eeprom32_address) ;
     Eeprom32_process_state = E32_WRITESTART ;
 #else
     eeAddress = Eeprom32_address ;
@@ -567,6 +727,7 @@ void ee32_process()
 
   if (Eeprom32_process_state == E32_WRITESTART) {
     uint32_t total_size ;
+    uint32_t size = Eeprom32_data_size ;
     p = Eeprom32_source_address;
     q = (uint8_t *) &Eeprom_buffer.data;
     if (p != q) {
@@ -574,11 +735,16 @@ void ee32_process()
         *q++ = *p++; // Copy the data to temp buffer
       }
     }
+    // the buffer shadows the whole file once written
+    memset(&Eeprom_buffer.data.bytes[Eeprom32_data_size], 0, sizeof(Eeprom_buffer.data) - Eeprom32_data_size);
+    while (size > EE32_TRIM_MIN && Eeprom_buffer.data.bytes[size-1] == 0) {
+      size -= 1;
+    }
     Eeprom_buffer.header.sequence_no = ++File_system[Eeprom32_file_index].sequence_no;
-    File_system[Eeprom32_file_index].size = Eeprom_buffer.header.data_size = Eeprom32_data_size;
-    Eeprom_buffer.header.flags = 0;
+    File_system[Eeprom32_file_index].size = Eeprom_buffer.header.data_size = size;
+    Eeprom_buffer.header.flags = EE32_FLAG_JOURNAL;
     Eeprom_buffer.header.hcsum = byte_checksum((uint8_t *) &Eeprom_buffer, 7);
-    total_size = Eeprom32_data_size + sizeof(struct t_eeprom_header);
+    total_size = size + sizeof(struct t_eeprom_header);
     eeAddress = Eeprom32_address; // Block start address
     x = total_size / 256; // # sub blocks
     x <<= 8; // to offset address
@@ -621,6 +787,8 @@ void ee32_process()
       else
       {
         File_system[Eeprom32_file_index].block_no ^= 1 ;        // This is now the current block
+        File_system[Eeprom32_file_index].journal = sizeof(struct t_eeprom_header) + File_system[Eeprom32_file_index].size ;
+        Eeprom32_shadow_file = Eeprom32_file_index ;
 #if 0
         // now erase the other block
         File_system[Eeprom32_file_index].block_no ^= 1 ;	// This is now the current block
@@ -640,6 +808,26 @@ void ee32_process()
     }
   }
 
+  if ( Eeprom32_process_state == E32_JOURNALSENDING )
+  {
+    if ( Spi_complete )
+    {
+      Eeprom32_process_state = E32_JOURNALWAITING ;
+    }
+  }
+
+  if ( Eeprom32_process_state == E32_JOURNALWAITING )
+  {
+    x = eeprom_read_status() ;
+    if ( ( x & 1 ) == 0 )
+    {
+      if ( Eeprom32_journal_size )
+        ee32_journal_write() ;
+      else
+        Eeprom32_process_state = E32_IDLE ;
+    }
+  }
+
   if ( Eeprom32_process_state == E32_ERASESENDING )
   {
     if ( Spi_complete )
@@ -694,7 +882,7 @@ const pm_char * eeBackupModel(uint8_t i_fileSrc)
   strcpy(statusLineMsg, PSTR("File "));
   strcpy(statusLineMsg+5, &buf[sizeof(MODELS_PATH)]);
 
-  uint16_t size = File_system[i_fileSrc+1].size;
+  uint16_t size = File_system[i_fileSrc+1].size ? sizeof(g_model) : 0;
 
   *(uint32_t*)&buf[0] = O9X_FOURCC;
   buf[4] = g_eeGeneral.version;
@@ -707,7 +895,7 @@ const pm_char * eeBackupModel(uint8_t i_fileSrc)
     return SDCARD_ERROR(result);
   }
 
-  read32_eeprom_data( (File_system[i_fileSrc+1].block_no << 12) + sizeof( struct t_eeprom_header), ( uint8_t *)&Eeprom_buffer.data.model_data, size) ;
+  ee32_read_shadow(i_fileSrc+1) ;
   result = f_write(&archiveFile, (uint8_t *)&Eeprom_buffer.data.model_data, size, &written);
   f_close(&archiveFile);
   if (result != FR_OK || written != size) {
@@ -762,6 +950,7 @@ const pm_char * eeRestoreModel(uint8_t i_fileDst, char *model_name)
     eeDeleteModel(i_fileDst);
   }
 
+  Eeprom32_shadow_file = 0xFF;
   memset((uint8_t *)&Eeprom_buffer.data.model_data, 0, sizeof(g_model));
   result = f_read(&restoreFile, ( uint8_t *)&Eeprom_buffer.data.model_data, size, &read);
   f_close(&restoreFile);
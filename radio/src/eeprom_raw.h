@@ -50,6 +50,8 @@
 #define E32_READWAITING                         7
 #define E32_BLANKCHECK                          8
 #define E32_WRITESTART                          9
+#define E32_JOURNALSENDING                      10
+#define E32_JOURNALWAITING                      11
 extern uint8_t Eeprom32_process_state ;
 extern uint8_t *Eeprom32_source_address ;
 extern uint8_t Eeprom32_file_index ;
@@ -73,6 +75,7 @@ struct t_file_entry
     uint32_t sequence_no ;
     uint16_t size ;
     uint8_t flags ;
+    uint16_t journal ;                  // end of the journal in the block, 0 when not known yet
 } ;
 
 struct t_eeprom_header
@@ -83,6 +86,19 @@ struct t_eeprom_header
     uint8_t hcsum ;
 };
 
+// Flags in t_eeprom_header
+// The end of the block holds a journal which has to be replayed over the image,
+// the journal of a block without this flag is ignored and the next save compacts it
+#define EE32_FLAG_JOURNAL                       0x01
+
+// Changes saved after the image, in the erased end of its block
+struct t_journal_record
+{
+    uint16_t offset ;                   // offset in the data area, 0xFFFF for the end of the journal
+    uint8_t size ;
+    uint8_t csum ;                      // sum of the offset, size and data bytes
+};
+
 extern struct t_file_entry File_system[] ;
 
 extern EEGeneral  g_eeGeneral;
@@ -94,6 +110,7 @@ extern uint8_t Spi_rx_buf[] ;
 void eeprom_write_enable();
 uint32_t eeprom_read_status();
 void read32_eeprom_data(uint32_t eeAddress, register uint8_t *buffer, uint32_t size, uint32_t immediate=0);
+uint32_t read32_eeprom_file(uint32_t block_no, uint16_t size, uint8_t *buffer, uint32_t length);
 uint32_t spi_PDC_action( register uint8_t *command, register uint8_t *tx, register uint8_t *rx, register uint32_t comlen, register uint32_t count );
 
 #if defined(SDCARD)
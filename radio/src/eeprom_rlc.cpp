@@ -45,6 +45,30 @@ EeFs      eeFs;
 
 #if defined(CPUARM)
 blkid_t   freeBlocks = 0;
+
+/*
+ * The model index is a chain of blocks, referenced by eeFs.modelIndex,
+ * holding a copy of each model header. It allows the model list to be
+ * loaded without decompressing every model file. An entry is trusted only
+ * if its checksum, its copy of the model DirEnt and the checksum of the
+ * first block of the model file are right, otherwise the header is read
+ * again from the model file. The DirEnt alone isn't enough, the writer
+ * alternates between two chains which may start at the same block.
+ */
+PACK(struct ModelIndexEntry {
+  ModelHeader header;
+  DirEnt      file;
+  uint16_t    fileChecksum;
+  uint8_t     checksum;
+});
+
+#define MODEL_INDEX_HEADER   2 // EEPROM_VER, sizeof(ModelIndexEntry)
+#define MODEL_INDEX_SIZE     (MODEL_INDEX_HEADER + MAX_MODELS*sizeof(ModelIndexEntry))
+#define MODEL_INDEX_BLOCKS   ((MODEL_INDEX_SIZE + BS-sizeof(blkid_t)-1) / (BS-sizeof(blkid_t)))
+// the index never takes the room needed to save a model
+#define MODEL_INDEX_MIN_FREE (MODEL_INDEX_BLOCKS + (sizeof(ModelData) + BS-sizeof(blkid_t)-1) / (BS-sizeof(blkid_t)))
+
+static blkid_t modelIndexBlocks[MODEL_INDEX_BLOCKS]; // modelIndexBlocks[0] == 0 when not loaded
 #endif
 
 uint8_t  s_sync_write = false;
@@ -214,11 +238,20 @@ int8_t EeFsck()
 #if defined(PCBTARANIS)
   blkid_t blocksCount;
 #endif
+#if defined(CPUARM)
+  // the model index is checked last, it is dropped if its blocks are used elsewhere
+  for (uint8_t i=0; i<=MAXFILES+1; i++) {
+#else
   for (uint8_t i=0; i<=MAXFILES; i++) {
+#endif
 #if defined(PCBTARANIS)
     blocksCount = 0;
 #endif
+#if defined(CPUARM)
+    blkid_t *startP = (i==MAXFILES+1 ? &eeFs.modelIndex : (i==MAXFILES ? &eeFs.freeList : &eeFs.files[i].startBlk));
+#else
     blkid_t *startP = (i==MAXFILES ? &eeFs.freeList : &eeFs.files[i].startBlk);
+#endif
     blkid_t lastBlk = 0;
     blk = *startP;
     while (blk) {
@@ -244,11 +277,12 @@ int8_t EeFsck()
         blk       = EeFsGetLink(blk);
       }
     }
-  }
-
 #if defined(PCBTARANIS)
-  freeBlocks = blocksCount;
+    if (i == MAXFILES) {
+      freeBlocks = blocksCount;
+    }
 #endif
+  }
 
   for (blk=FIRSTBLK; blk<BLOCKS; blk++) {
     if (!bufp[blk]) { // unused block
@@ -281,7 +315,10 @@ void EeFsFormat()
   EeFsSetLink(BLOCKS-1, 0);
   eeFs.freeList = FIRSTBLK;
 #if defined(PCBTARANIS)
-  freeBlocks = BLOCKS;
+  freeBlocks = BLOCKS-FIRSTBLK;
+#endif
+#if defined(CPUARM)
+  modelIndexBlocks[0] = 0;
 #endif
   EeFsFlush();
 
@@ -411,6 +448,280 @@ uint16_t RlcFile::readRlc(uint8_t *buf, uint16_t i_len)
   return i;
 }
 
+#if defined(CPUARM)
+static void eeModelIndexAccess(uint16_t ofs, uint8_t *buf, uint8_t len, bool write)
+{
+  while (len) {
+    blkid_t blk = modelIndexBlocks[ofs / (BS-sizeof(blkid_t))];
+    uint8_t blkOfs = ofs % (BS-sizeof(blkid_t));
+    uint8_t count = min<uint8_t>(len, BS-sizeof(blkid_t)-blkOfs);
+    if (write)
+      EeFsSetDat(blk, blkOfs, buf, count);
+    else
+      eeprom_read_block(buf, (blk*BS)+blkOfs+sizeof(blkid_t)+BLOCKS_OFFSET, count);
+    ofs += count;
+    buf += count;
+    len -= count;
+  }
+}
+
+static uint8_t modelIndexChecksum(ModelIndexEntry & entry)
+{
+  uint8_t result = 0;
+  for (uint8_t i=0; i<offsetof(ModelIndexEntry, checksum); i++) {
+    result += ((uint8_t *)&entry)[i];
+  }
+  return result;
+}
+
+/*
+ * Checksum of the first block of the model file, the header as written
+ */
+static uint16_t modelFileChecksum(uint8_t id)
+{
+  DirEnt & file = eeFs.files[FILE_MODEL(id)];
+  uint8_t buf[BS-sizeof(blkid_t)];
+  uint8_t len = min<uint16_t>(file.size, sizeof(buf));
+  uint16_t result = 0;
+  if (file.startBlk) {
+    eeprom_read_block(buf, (file.startBlk*BS)+sizeof(blkid_t)+BLOCKS_OFFSET, len);
+    for (uint8_t i=0; i<len; i++) {
+      result = ((result << 1) | (result >> 15)) + buf[i];
+    }
+  }
+  return result;
+}
+
+static void eeWriteModelIndexEntry(uint8_t id, ModelHeader * header)
+{
+  ModelIndexEntry entry;
+  memcpy(&entry.header, header, sizeof(ModelHeader));
+  entry.file = eeFs.files[FILE_MODEL(id)];
+  entry.fileChecksum = modelFileChecksum(id);
+  entry.checksum = modelIndexChecksum(entry);
+  eeModelIndexAccess(MODEL_INDEX_HEADER+id*sizeof(ModelIndexEntry), (uint8_t *)&entry, sizeof(entry), true);
+}
+
+static void EeFsFlushModelIndex()
+{
+  eeWriteBlockCmp((uint8_t *)&eeFs.modelIndex, offsetof(EeFs, modelIndex), sizeof(eeFs.modelIndex));
+}
+
+static bool eeCreateModelIndex()
+{
+  if (freeBlocks < MODEL_INDEX_MIN_FREE) {
+    return false;
+  }
+
+  for (uint8_t i=0; i<MODEL_INDEX_BLOCKS; i++) {
+    modelIndexBlocks[i] = eeFs.freeList;
+    eeFs.freeList = EeFsGetLink(eeFs.freeList);
+    freeBlocks--;
+  }
+  EeFsSetLink(modelIndexBlocks[MODEL_INDEX_BLOCKS-1], 0);
+  EeFsFlushFreelist();
+
+  uint8_t header[MODEL_INDEX_HEADER] = { EEPROM_VER, sizeof(ModelIndexEntry) };
+  eeModelIndexAccess(0, header, MODEL_INDEX_HEADER, true);
+  for (uint8_t i=0; i<MAX_MODELS; i++) {
+    eeWriteModelIndexEntry(i, &modelHeaders[i]);
+  }
+
+  // the index is referenced only once complete, EeFsck() gives the blocks back otherwise
+  eeFs.modelIndex = modelIndexBlocks[0];
+  EeFsFlushModelIndex();
+  return true;
+}
+
+void eeReleaseModelIndex()
+{
+  blkid_t blk = eeFs.modelIndex;
+  modelIndexBlocks[0] = 0;
+  if (blk) {
+    eeFs.modelIndex = 0;
+    EeFsFlushModelIndex();
+    EeFsFree(blk);
+  }
+}
+
+void eeLoadModelIndex()
+{
+  blkid_t blk = eeFs.modelIndex;
+  for (uint8_t i=0; i<MODEL_INDEX_BLOCKS; i++) {
+    modelIndexBlocks[i] = blk;
+    if (blk) blk = EeFsGetLink(blk);
+  }
+
+  uint8_t header[MODEL_INDEX_HEADER];
+  if (modelIndexBlocks[MODEL_INDEX_BLOCKS-1]) {
+    eeModelIndexAccess(0, header, MODEL_INDEX_HEADER, false);
+  }
+
+  if (!modelIndexBlocks[MODEL_INDEX_BLOCKS-1] || header[0] != EEPROM_VER || header[1] != sizeof(ModelIndexEntry)) {
+    TRACE("model index rebuilt");
+    eeReleaseModelIndex();
+    eeLoadModelHeaders();
+    eeCreateModelIndex();
+    return;
+  }
+
+  for (uint8_t i=0; i<MAX_MODELS; i++) {
+    ModelIndexEntry entry;
+    eeModelIndexAccess(MODEL_INDEX_HEADER+i*sizeof(ModelIndexEntry), (uint8_t *)&entry, sizeof(entry), false);
+    if (entry.checksum == modelIndexChecksum(entry) && !memcmp(&entry.file, &eeFs.files[FILE_MODEL(i)], sizeof(DirEnt)) && entry.fileChecksum == modelFileChecksum(i)) {
+      memcpy(&modelHeaders[i], &entry.header, sizeof(ModelHeader));
+    }
+    else {
+      eeLoadModelHeader(i, &modelHeaders[i]);
+      eeWriteModelIndexEntry(i, &modelHeaders[i]);
+    }
+  }
+}
+
+/*
+ * Called once the model file has been written
+ */
+void eeUpdateModelIndex(uint8_t id)
+{
+  if (modelIndexBlocks[0] && id < MAX_MODELS) {
+    RlcFile file;
+    ModelHeader header;
+    memclear(&header, sizeof(header));
+    file.openRlc(FILE_MODEL(id));
+    file.readRlc((uint8_t *)&header, sizeof(header));
+    eeWriteModelIndexEntry(id, &header);
+  }
+}
+
+#endif
+
+#if defined(CPUARM)
+void RlcFile::write(uint8_t *buf, uint8_t i_len)
+{
+  while (i_len && !s_write_err) {
+    if (m_block_len == BS-sizeof(blkid_t)) {
+      writeBlock(false);
+      continue;
+    }
+    uint8_t len = min<uint8_t>(i_len, BS-sizeof(blkid_t)-m_block_len);
+    memcpy(&m_block[sizeof(blkid_t)+m_block_len], buf, len);
+    m_block_len += len;
+    buf += len;
+    i_len -= len;
+  }
+}
+
+/*
+ * The blocks are taken from the previous FILE_TMP chain, then from the
+ * reserved ones, which have already left the free list on the EEPROM
+ */
+blkid_t RlcFile::allocBlock()
+{
+  blkid_t blk = m_unused;
+  if (blk) {
+    m_unused = EeFsGetLink(blk);
+  }
+  else if ((blk = m_reserved)) {
+    m_reserved = EeFsGetLink(blk);
+  }
+  return blk;
+}
+
+/*
+ * Size of the compressed data left in m_rlc_buf
+ */
+uint16_t RlcFile::rlcSize()
+{
+  uint8_t * buf = m_rlc_buf;
+  uint16_t len = m_rlc_len;
+  uint16_t size = 0;
+
+  while (nextRlcToken()) {
+    size += 1 + m_cur_rlc_len;
+    m_rlc_buf += m_cur_rlc_len;
+    m_cur_rlc_len = 0;
+  }
+
+  m_rlc_buf = buf;
+  m_rlc_len = len;
+  return size;
+}
+
+void RlcFile::setReserve(uint16_t size)
+{
+  blkid_t needed = max<blkid_t>(1, (size + BS-sizeof(blkid_t)-1) / (BS-sizeof(blkid_t)));
+  for (blkid_t blk=m_unused; blk && needed; blk=EeFsGetLink(blk)) {
+    needed--;
+  }
+  m_reserve = needed;
+  m_write_step = WRITE_RESERVE_STEP1;
+}
+
+bool RlcFile::reserve(uint16_t size)
+{
+  setReserve(size);
+  while (m_write_step != WRITE_DATA_STEP && !s_write_err) {
+    nextRlcWriteStep();
+  }
+  return !s_write_err;
+}
+
+/*
+ * Write the block buffer with the link to the next block
+ */
+void RlcFile::writeBlock(bool last)
+{
+  if (!m_currBlk) {
+    m_currBlk = eeFs.files[FILE_TMP].startBlk = allocBlock();
+  }
+
+  blkid_t next = (last ? 0 : allocBlock());
+  if (!m_currBlk || (!last && !next)) {
+    s_write_err = ERR_FULL;
+    return;
+  }
+
+  memcpy(m_block, &next, sizeof(blkid_t));
+  eeWriteBlockCmp(m_block, (m_currBlk*BS)+BLOCKS_OFFSET, sizeof(blkid_t)+m_block_len);
+  m_pos += m_block_len;
+  m_block_len = 0;
+  m_currBlk = next;
+}
+
+/*
+ * Compress the data left into the block buffer, until it is full
+ */
+void RlcFile::fillRlcBlock()
+{
+  while (m_block_len < BS-sizeof(blkid_t)) {
+    if (m_cur_rlc_len) {
+      uint8_t len = min<uint8_t>(m_cur_rlc_len, BS-sizeof(blkid_t)-m_block_len);
+      memcpy(&m_block[sizeof(blkid_t)+m_block_len], m_rlc_buf, len);
+      m_rlc_buf += len;
+      m_cur_rlc_len -= len;
+      m_block_len += len;
+    }
+    else {
+      uint8_t token = nextRlcToken();
+      if (!token)
+        break;
+      m_block[sizeof(blkid_t)+m_block_len++] = token;
+    }
+  }
+}
+
+// Runs the remaining write steps at once. Copy and restore from SD end here,
+// the file is used (swapped, converted or loaded) right after.
+void RlcFile::close()
+{
+  m_rlc_len = 0;
+  m_cur_rlc_len = 0;
+  m_write_step = WRITE_DATA_STEP;
+  while (m_write_step && !s_write_err) {
+    nextRlcWriteStep();
+  }
+}
+#else
 void RlcFile::write1(uint8_t b)
 {
   m_write1_byte = b;
@@ -502,6 +813,7 @@ void RlcFile::nextWriteStep()
     nextRlcWriteStep();
   }
 }
+#endif
 
 void RlcFile::create(uint8_t i_fileId, uint8_t typ, uint8_t sync_write)
 {
@@ -510,6 +822,15 @@ void RlcFile::create(uint8_t i_fileId, uint8_t typ, uint8_t sync_write)
   eeFs.files[FILE_TMP].typ      = typ;
   eeFs.files[FILE_TMP].size     = 0;
   m_fileId = i_fileId;
+#if defined(CPUARM)
+  // the FILE_TMP chain is given back to the free list when the file is closed
+  m_unused = eeFs.files[FILE_TMP].startBlk;
+  eeFs.files[FILE_TMP].startBlk = 0;
+  m_reserved = 0;
+  m_reserve = 0;
+  m_currBlk = 0;
+  m_block_len = 0;
+#endif
   ENABLE_SYNC_WRITE(sync_write);
 }
 
@@ -523,6 +844,13 @@ bool RlcFile::copy(uint8_t i_fileDst, uint8_t i_fileSrc)
 
   create(i_fileDst, FILE_TYP_MODEL/*optimization, only model files are copied. should be eeFs.files[i_fileSrc].typ*/, true);
 
+#if defined(CPUARM)
+  if (!reserve(eeFs.files[i_fileSrc].size)) {
+    ENABLE_SYNC_WRITE(false);
+    return false;
+  }
+#endif
+
   uint8_t buf[BS-sizeof(blkid_t)];
   uint8_t len;
   while ((len=theFile2.read(buf, sizeof(buf))))
@@ -534,6 +862,13 @@ bool RlcFile::copy(uint8_t i_fileDst, uint8_t i_fileSrc)
     }
   }
 
+#if defined(CPUARM)
+  close();
+  ENABLE_SYNC_WRITE(false);
+  if (write_errno() != 0) {
+    return false;
+  }
+#else
   blkid_t fri=0;
   if (m_currBlk && (fri=EeFsGetLink(m_currBlk)))
     EeFsSetLink(m_currBlk, 0);
@@ -546,6 +881,8 @@ bool RlcFile::copy(uint8_t i_fileDst, uint8_t i_fileSrc)
   assert(!m_write_step);
 
   // s_sync_write is set to false in swap();
+#endif
+
   return true;
 }
 
@@ -679,6 +1016,14 @@ const pm_char * eeRestoreModel(uint8_t i_fileDst, char *model_name)
 
   theFile.create(FILE_MODEL(i_fileDst), FILE_TYP_MODEL, true);
 
+#if defined(CPUARM)
+  if (!theFile.reserve(f_size(&g_oLogFile) - 8)) {
+    ENABLE_SYNC_WRITE(false);
+    f_close(&g_oLogFile);
+    return STR_EEPROMOVERFLOW;
+  }
+#endif
+
   do {
     result = f_read(&g_oLogFile, (uint8_t *)buf, 15, &read);
     if (result != FR_OK) {
@@ -696,6 +1041,14 @@ const pm_char * eeRestoreModel(uint8_t i_fileDst, char *model_name)
     }
   } while (read == 15);
 
+#if defined(CPUARM)
+  theFile.close();
+  ENABLE_SYNC_WRITE(false);
+  if (write_errno() != 0) {
+    f_close(&g_oLogFile);
+    return STR_EEPROMOVERFLOW;
+  }
+#else
   blkid_t fri=0;
   if (theFile.m_currBlk && (fri=EeFsGetLink(theFile.m_currBlk)))
     EeFsSetLink(theFile.m_currBlk, 0);
@@ -704,6 +1057,7 @@ const pm_char * eeRestoreModel(uint8_t i_fileDst, char *model_name)
 
   eeFs.files[FILE_TMP].size = theFile.m_pos;
   EFile::swap(theFile.m_fileId, FILE_TMP); // s_sync_write is set to false in swap();
+#endif
 
   f_close(&g_oLogFile);
 
@@ -740,26 +1094,21 @@ void RlcFile::writeRlc(uint8_t i_fileId, uint8_t typ, uint8_t *buf, uint16_t i_l
   } while (IS_SYNC_WRITE_ENABLE() && m_write_step && !s_write_err);
 }
 
-void RlcFile::nextRlcWriteStep()
+/*
+ * Compress the next run of m_rlc_buf, return its control byte or 0 when
+ * all data has been compressed. Data bytes following the control byte
+ * (m_cur_rlc_len) are left in m_rlc_buf
+ */
+uint8_t RlcFile::nextRlcToken()
 {
   uint8_t cnt    = 1;
   uint8_t cnt0   = 0;
-  uint16_t i = 0;
 
-  if (m_cur_rlc_len) {
-    uint8_t tmp1 = m_cur_rlc_len;
-    uint8_t *tmp2 = m_rlc_buf;
-    m_rlc_buf += m_cur_rlc_len;
-    m_cur_rlc_len = 0;
-    write(tmp2, tmp1);
-    return;
-  }
+  if (m_rlc_len==0) return 0;
 
   bool run0 = (m_rlc_buf[0] == 0);
 
-  if (m_rlc_len==0) goto close;
-
-  for (i=1; 1; i++) { // !! laeuft ein byte zu weit !!
+  for (uint16_t i=1; 1; i++) { // !! laeuft ein byte zu weit !!
     bool cur0 = m_rlc_buf[i] == 0;
     if (cur0 != run0 || cnt==0x3f || (cnt0 && cnt==0x0f) || i==m_rlc_len) {
       if (run0) {
@@ -769,21 +1118,17 @@ void RlcFile::nextRlcWriteStep()
         else {
           m_rlc_buf+=cnt;
           m_rlc_len-=cnt;
-          write1(cnt|0x40);
-          return;
+          return cnt|0x40;
         }
       }
       else {
         m_rlc_buf+=cnt0;
         m_rlc_len-=cnt0+cnt;
         m_cur_rlc_len=cnt;
-        if(cnt0){
-          write1(0x80 | (cnt0<<4) | cnt);
-        }
-        else{
-          write1(cnt);
-        }
-        return;
+        if (cnt0)
+          return 0x80 | (cnt0<<4) | cnt;
+        else
+          return cnt;
       }
       cnt=0;
       if (i==m_rlc_len) break;
@@ -792,7 +1137,175 @@ void RlcFile::nextRlcWriteStep()
     cnt++;
   }
 
-  close:
+  return 0;
+}
+
+#if defined(CPUARM)
+/*
+ * One step is one EEPROM page: a full block (link included), a link, the
+ * free list or a directory entry.
+ * The blocks missing in the previous FILE_TMP chain are removed from the
+ * free list, and their chain terminated, before any data is written. The
+ * free list on the EEPROM never goes through a block being written, an
+ * interrupted write only leaves orphan blocks, which EeFsck() gives back.
+ */
+void RlcFile::nextRlcWriteStep()
+{
+  bool written = false;
+
+  while (!written && m_write_step && !s_write_err) {
+    written = true;
+
+    switch (m_write_step) {
+      case WRITE_START_STEP:
+        setReserve(rlcSize());
+        written = false;
+        break;
+
+      case WRITE_RESERVE_STEP1:
+        if (!m_reserve) {
+          m_write_step = WRITE_DATA_STEP;
+          written = false;
+        }
+        else if (m_reserve <= freeBlocks) {
+          blkid_t blk = m_reserved = eeFs.freeList;
+          for (blkid_t i=1; i<m_reserve; i++) {
+            blk = EeFsGetLink(blk);
+          }
+          m_reserved_last = blk;
+          eeFs.freeList = EeFsGetLink(blk);
+          freeBlocks -= m_reserve;
+          m_write_step = WRITE_RESERVE_STEP2;
+          EeFsFlushFreelist();
+        }
+        else if (eeFs.modelIndex && m_reserve <= freeBlocks + MODEL_INDEX_BLOCKS) {
+          // models data first, the index will be rebuilt at next start if there is room
+          m_reserved = eeFs.modelIndex;
+          modelIndexBlocks[0] = 0;
+          eeFs.modelIndex = 0;
+          m_write_step = WRITE_RELEASE_INDEX_STEP;
+          EeFsFlushModelIndex();
+        }
+        else {
+          // nothing has been written, the previous FILE_TMP chain is kept
+          eeFs.files[FILE_TMP].startBlk = m_unused;
+          s_write_err = ERR_FULL;
+        }
+        break;
+
+      case WRITE_RELEASE_INDEX_STEP:
+      {
+        // the released index chain goes in front of the free list
+        blkid_t blk = m_reserved;
+        blkid_t next;
+        freeBlocks++;
+        while ((next = EeFsGetLink(blk))) {
+          blk = next;
+          freeBlocks++;
+        }
+        m_write_step = WRITE_RESERVE_STEP1;
+        EeFsSetLink(blk, eeFs.freeList);
+        eeFs.freeList = m_reserved;
+        m_reserved = 0;
+        break;
+      }
+
+      case WRITE_RESERVE_STEP2:
+        m_write_step = WRITE_DATA_STEP;
+        EeFsSetLink(m_reserved_last, 0);
+        break;
+
+      case WRITE_DATA_STEP:
+        fillRlcBlock();
+        if (m_cur_rlc_len || m_rlc_len) {
+          writeBlock(false);
+          break;
+        }
+        m_write_step = WRITE_FREE_UNUSED_BLOCKS_STEP1;
+        if (m_block_len || !eeFs.files[FILE_TMP].startBlk)
+          writeBlock(true);
+        else
+          written = false;
+        break;
+
+      case WRITE_FREE_UNUSED_BLOCKS_STEP1:
+        if (!m_unused) {
+          m_unused = m_reserved;
+          m_reserved = 0;
+        }
+        if (m_unused) {
+          // the unused chain, already orphan, is linked to the free list first
+          blkid_t blk = m_unused;
+          blkid_t next;
+          freeBlocks++;
+          while ((next = EeFsGetLink(blk))) {
+            blk = next;
+            freeBlocks++;
+          }
+          m_write_step = WRITE_FREE_UNUSED_BLOCKS_STEP2;
+          EeFsSetLink(blk, eeFs.freeList);
+        }
+        else {
+          m_write_step = WRITE_FINAL_DIRENT_STEP;
+          written = false;
+        }
+        break;
+
+      case WRITE_FREE_UNUSED_BLOCKS_STEP2:
+        eeFs.freeList = m_unused;
+        m_unused = 0;
+        m_write_step = WRITE_FINAL_DIRENT_STEP;
+        EeFsFlushFreelist();
+        break;
+
+      case WRITE_FINAL_DIRENT_STEP: {
+        m_currBlk = eeFs.files[FILE_TMP].startBlk;
+        DirEnt & f = eeFs.files[m_fileId];
+        eeFs.files[FILE_TMP].startBlk = f.startBlk;
+        eeFs.files[FILE_TMP].size = f.size;
+        f.startBlk = m_currBlk;
+        f.size = m_pos;
+        f.typ = eeFs.files[FILE_TMP].typ;
+        m_write_step = WRITE_TMP_DIRENT_STEP;
+        EeFsFlushDirEnt(m_fileId);
+        break;
+      }
+
+      case WRITE_TMP_DIRENT_STEP:
+        m_write_step = (m_fileId == FILE_GENERAL ? 0 : WRITE_MODEL_INDEX_STEP);
+        EeFsFlushDirEnt(FILE_TMP);
+        break;
+
+      case WRITE_MODEL_INDEX_STEP:
+        m_write_step = 0;
+        eeUpdateModelIndex(m_fileId-1);
+        break;
+    }
+  }
+
+  if (s_write_err == ERR_FULL) {
+    POPUP_WARNING(STR_EEPROMOVERFLOW);
+    m_write_step = 0;
+    m_cur_rlc_len = 0;
+  }
+}
+#else
+void RlcFile::nextRlcWriteStep()
+{
+  if (m_cur_rlc_len) {
+    uint8_t tmp1 = m_cur_rlc_len;
+    uint8_t *tmp2 = m_rlc_buf;
+    m_rlc_buf += m_cur_rlc_len;
+    m_cur_rlc_len = 0;
+    write(tmp2, tmp1);
+    return;
+  }
+
+  uint8_t token = nextRlcToken();
+  if (token) {
+    write1(token);
+    return;
+  }
 
   switch(m_write_step) {
     case WRITE_START_STEP: {
@@ -846,6 +1359,7 @@ void RlcFile::nextRlcWriteStep()
       return;
   }
 }
+#endif
 
 void RlcFile::flush()
 {
@@ -855,8 +1369,10 @@ void RlcFile::flush()
 
   ENABLE_SYNC_WRITE(true);
 
+#if !defined(CPUARM)
   while (m_write_len && !s_write_err)
     nextWriteStep();
+#endif
 
   while (isWriting() && !s_write_err)
     nextRlcWriteStep();
@@ -972,7 +1488,7 @@ void eeLoadModel(uint8_t id)
     }
 
     AUDIO_FLUSH();
-    flightReset();
+    flightReset(true);
     logicalSwitchesReset();
 
     if (pulsesStarted()) {
@@ -1038,7 +1554,11 @@ void eeReadAll()
     theFile.writeRlc(FILE_MODEL(0), FILE_TYP_MODEL, (uint8_t*)&g_model, sizeof(g_model), true);
   }
   else {
+#if defined(CPUARM)
+    eeLoadModelIndex();
+#else
     eeLoadModelHeaders();
+#endif
   }
 
   stickMode = g_eeGeneral.stickMode;
@@ -1101,6 +1621,8 @@ bool eeCopyModel(uint8_t dst, uint8_t src)
 void eeSwapModels(uint8_t id1, uint8_t id2)
 {
   EFile::swap(FILE_MODEL(id1), FILE_MODEL(id2));
+  eeUpdateModelIndex(id1);
+  eeUpdateModelIndex(id2);
 
   char tmp[sizeof(g_model.header)];
   memcpy(tmp, &modelHeaders[id1], sizeof(ModelHeader));
@@ -1111,6 +1633,7 @@ void eeSwapModels(uint8_t id1, uint8_t id2)
 void eeDeleteModel(uint8_t idx)
 {
   EFile::rm(FILE_MODEL(idx));
+  eeUpdateModelIndex(idx);
   memset(&modelHeaders[idx], 0, sizeof(ModelHeader));
 }
 #endif
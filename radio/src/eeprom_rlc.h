@@ -79,7 +79,7 @@ PACK(struct DirEnt {
 });
 
 #if defined(CPUARM)
-#define EEFS_EXTRA_FIELDS uint8_t  spare[2];
+#define EEFS_EXTRA_FIELDS blkid_t  modelIndex; // chain of the model headers copies, see eeLoadModelIndex()
 #else
 #define EEFS_EXTRA_FIELDS
 #endif
@@ -178,13 +178,29 @@ class RlcFile: public EFile
 #define WRITE_FREE_UNUSED_BLOCKS_STEP2 0x30
 #define WRITE_FINAL_DIRENT_STEP        0x40
 #define WRITE_TMP_DIRENT_STEP          0x50
+#define WRITE_MODEL_INDEX_STEP         0x60
+#define WRITE_RESERVE_STEP1            0x70
+#define WRITE_RESERVE_STEP2            0x80
+#define WRITE_RELEASE_INDEX_STEP       0x90
+#define WRITE_DATA_STEP                0xA0
     uint8_t m_write_step;
     uint16_t m_rlc_len;
     uint8_t * m_rlc_buf;
     uint8_t m_cur_rlc_len;
+#if defined(CPUARM)
+    // the compressor fills m_block (link included) which is then
+    // written in one go, a full block being one EEPROM page
+    uint8_t m_block[BS];
+    uint8_t m_block_len;
+    blkid_t m_unused;     // blocks left from the previous FILE_TMP, reused first
+    blkid_t m_reserved;   // blocks taken from the free list before writing, used next
+    blkid_t m_reserved_last;
+    blkid_t m_reserve;    // count of blocks to take from the free list
+#else
     uint8_t m_write1_byte;
     uint8_t m_write_len;
     uint8_t * m_write_buf;
+#endif
 #if defined (EEPROM_PROGRESS_BAR)
     uint8_t m_ratio;
 #endif
@@ -200,8 +216,21 @@ class RlcFile: public EFile
 
     inline bool isWriting() { return m_write_step != 0; }
     void write(uint8_t *buf, uint8_t i_len);
+#if defined(CPUARM)
+    blkid_t allocBlock();
+    void writeBlock(bool last);
+    void fillRlcBlock();
+    uint16_t rlcSize();
+    void setReserve(uint16_t size);
+    // take from the free list the blocks needed to write size bytes
+    bool reserve(uint16_t size);
+    // write the last block and replace the file with FILE_TMP
+    void close();
+#else
     void write1(uint8_t b);
     void nextWriteStep();
+#endif
+    uint8_t nextRlcToken();
     void nextRlcWriteStep();
     void writeRlc(uint8_t i_fileId, uint8_t typ, uint8_t *buf, uint16_t i_len, uint8_t sync_write);
 
@@ -230,6 +259,9 @@ inline void eeFlush() { theFile.flush(); }
 bool eeCopyModel(uint8_t dst, uint8_t src);
 void eeSwapModels(uint8_t id1, uint8_t id2);
 void eeDeleteModel(uint8_t idx);
+void eeLoadModelIndex();
+void eeUpdateModelIndex(uint8_t id);
+void eeReleaseModelIndex();
 #else
 #define eeCopyModel(dst, src) theFile.copy(FILE_MODEL(dst), FILE_MODEL(src))
 #define eeSwapModels(id1, id2) EFile::swap(FILE_MODEL(id1), FILE_MODEL(id2))
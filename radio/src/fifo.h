@@ -37,33 +37,104 @@
 #ifndef _FIFO_H_
 #define _FIFO_H_
 
-template <int N>
+// Single producer / single consumer ring buffer. The producer (usually an
+// interrupt handler) only writes widx, the consumer only writes ridx, so no
+// locking is needed. The barriers make the elements visible before the index
+// which publishes them (release) and read the index before the elements it
+// guards (acquire). One slot is kept free, N doesn't need to be a power of 2.
+template <int N, class T=uint8_t>
 class Fifo
 {
   public:
     Fifo():
+      fifo(),
       widx(0),
-      ridx(0)
+      ridx(0),
+      overruns(0),
+      highWater(0)
     {
     }
 
-    void push(uint8_t byte) {
-      uint32_t next = (widx+1) & (N-1);
-      if (next != ridx) {
-        fifo[widx] = byte;
-        widx = next;
+    bool push(T element) {
+      uint32_t w = widx;
+      uint32_t next = increment(w);
+      if (next == ridx) {
+        overruns++;
+        return false;
       }
+      fifo[w] = element;
+      __sync_synchronize();
+      widx = next;
+      updateHighWater(next);
+      return true;
     }
 
-    bool pop(uint8_t & byte) {
-      if (empty()) {
+    bool pop(T & element) {
+      uint32_t r = ridx;
+      if (r == widx) {
         return false;
       }
-      else {
-        byte = fifo[ridx];
-        ridx = (ridx+1) & (N-1);
-        return true;
+      __sync_synchronize();
+      element = fifo[r];
+      __sync_synchronize();
+      ridx = increment(r);
+      return true;
+    }
+
+    // Producer side bulk copy, returns the number of elements written,
+    // the ones which didn't fit are counted as overruns
+    uint32_t write(const T * data, uint32_t count) {
+      uint32_t w = widx;
+      uint32_t free = (ridx + N - w - 1) % N;
+      if (count > free) {
+        overruns += count - free;
+        count = free;
+      }
+      for (uint32_t i=0; i<count; i++) {
+        fifo[w] = data[i];
+        w = increment(w);
       }
+      __sync_synchronize();
+      widx = w;
+      updateHighWater(w);
+      return count;
+    }
+
+    // Consumer side bulk copy, returns the number of elements read
+    uint32_t read(T * data, uint32_t count) {
+      uint32_t result = 0;
+      const T * region;
+      uint32_t len;
+      while (result < count && (len = peek(region)) > 0) {
+        if (len > count - result) {
+          len = count - result;
+        }
+        for (uint32_t i=0; i<len; i++) {
+          data[result+i] = region[i];
+        }
+        skip(len);
+        result += len;
+      }
+      return result;
+    }
+
+    // Gives the largest contiguous readable region without copying it,
+    // the elements stay in the fifo until skip() is called
+    uint32_t peek(const T * & data) {
+      uint32_t r = ridx;
+      uint32_t w = widx;
+      __sync_synchronize();
+      data = &fifo[r];
+      return (w >= r) ? w - r : N - r;
+    }
+
+    void skip(uint32_t count) {
+      __sync_synchronize();
+      ridx = (ridx + count) % N;
+    }
+
+    uint32_t size() {
+      return (widx + N - ridx) % N;
     }
 
     bool empty() {
@@ -74,10 +145,31 @@ class Fifo
       while (!empty()) {};
     }
 
+    uint32_t getOverruns() {
+      return overruns;
+    }
+
+    uint32_t getHighWater() {
+      return highWater;
+    }
+
   protected:
-    uint8_t fifo[N];
+    static uint32_t increment(uint32_t index) {
+      return (index == N-1) ? 0 : index+1;
+    }
+
+    void updateHighWater(uint32_t w) {
+      uint32_t count = (w + N - ridx) % N;
+      if (count > highWater) {
+        highWater = count;
+      }
+    }
+
+    T fifo[N];
     volatile uint32_t widx;
     volatile uint32_t ridx;
+    volatile uint32_t overruns;
+    volatile uint32_t highWater;
 };
 
 #endif
@@ -343,7 +343,7 @@ void evalFunctions()
                 break;
 #if defined(FRSKY)
               case FUNC_RESET_TELEMETRY:
-                telemetryReset();
+                telemetryRequestReset();
                 break;
 #endif
 #if ROTARY_ENCODERS > 0
@@ -210,11 +210,13 @@ void menuModelSetup(uint8_t event)
             case 1:
               CHECK_INCDEC_MODELVAR_ZERO(event, qr.quot, 59);
               timer->start = qr.rem + qr.quot*60;
+              timersStates[timerIdx].announce = TIMER_MIN; // the next announcement moved with the start
               break;
             case 2:
               qr.rem -= checkIncDecModel(event, qr.rem+2, 1, 62)-2;
               timer->start -= qr.rem ;
               if ((int16_t)timer->start < 0) timer->start=0;
+              timersStates[timerIdx].announce = TIMER_MIN;
               break;
           }
         }
@@ -284,10 +286,12 @@ void menuModelSetup(uint8_t event)
               case 1:
                 CHECK_INCDEC_MODELVAR_ZERO(event, qr.quot, 59);
                 timer->start = qr.rem + qr.quot*60;
+                timersStates[k>=ITEM_MODEL_TIMER2 ? 1 : 0].announce = TIMER_MIN; // the next announcement moved with the start
                 break;
               case 2:
                 qr.rem -= checkIncDecModel(event, qr.rem+2, 1, 62)-2;
                 timer->start -= qr.rem ;
+                timersStates[k>=ITEM_MODEL_TIMER2 ? 1 : 0].announce = TIMER_MIN;
                 break;
             }
           }
@@ -253,6 +253,7 @@ bool isSensorAvailable(int sensor)
 void menuModelSensor(uint8_t event)
 {
   TelemetrySensor * sensor = & g_model.telemetrySensors[s_currIdx];
+  TelemetrySensor previous = *sensor;
 
   SUBMENU(STR_MENUSENSOR, SENSOR_FIELD_MAX, {0, 0, sensor->type == TELEM_TYPE_CALCULATED ? (uint8_t)0 : (uint8_t)1, SENSOR_UNIT_ROWS, SENSOR_PREC_ROWS, SENSOR_PARAM1_ROWS, SENSOR_PARAM2_ROWS, SENSOR_PARAM3_ROWS, SENSOR_PARAM4_ROWS, 0 });
   lcd_outdezAtt(PSIZE(TR_MENUSENSOR)*FW+1, 0, s_currIdx+1, INVERS|LEFT);
@@ -437,6 +438,10 @@ void menuModelSensor(uint8_t event)
 
     }
   }
+
+  if (isTelemetryFormulaChanged(previous, *sensor)) {
+    telemetryInvalidateFormulas();
+  }
 }
 
 void onSensorMenu(const char *result)
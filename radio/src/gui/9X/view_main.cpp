@@ -259,7 +259,7 @@ void onMainViewMenu(const char *result)
 #endif
 #if defined(FRSKY)
   else if (result == STR_RESET_TELEMETRY) {
-    telemetryReset();
+    telemetryRequestReset();
   }
 #endif
   else if (result == STR_RESET_FLIGHT) {
@@ -528,7 +528,7 @@ void menuTelemetryFrsky(uint8_t event)
       break;
 
     case EVT_KEY_FIRST(KEY_ENTER):
-      telemetryReset();
+      telemetryRequestReset();
       break;
   }
 
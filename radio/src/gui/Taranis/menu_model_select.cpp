@@ -71,6 +71,7 @@ void onModelSelectMenu(const char *result)
   }
   else {
     // The user choosed a file on SD to restore
+    eeCheck(true); // force writing of current model data before the files are changed
     POPUP_WARNING(eeRestoreModel(sub, (char *)result));
     if (!s_warning && g_eeGeneral.currModel == sub)
       eeLoadModel(sub);
@@ -81,6 +82,7 @@ void menuModelSelect(uint8_t event)
 {
   if (s_warning_result) {
     s_warning_result = 0;
+    eeCheck(true); // force writing of current model data before the files are changed
     eeDeleteModel(m_posVert); // delete file
     s_copyMode = 0;
     event = EVT_ENTRY_UP;
@@ -106,7 +108,6 @@ void menuModelSelect(uint8_t event)
         if (sub >= NUM_BODY_LINES) s_pgOfs = sub-(NUM_BODY_LINES-1);
         s_copyMode = 0;
         s_editMode = EDIT_MODE_INIT;
-        eeCheck(true);
         break;
 
       case EVT_KEY_LONG(KEY_EXIT):
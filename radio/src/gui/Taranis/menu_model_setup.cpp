@@ -162,11 +162,13 @@ void editTimerMode(int timerIdx, coord_t y, LcdFlags attr, uint8_t event)
       case 1:
         CHECK_INCDEC_MODELVAR_ZERO(event, qr.quot, 59);
         timer->start = qr.rem + qr.quot*60;
+        timersStates[timerIdx].announce = TIMER_MIN; // the next announcement moved with the start
         break;
       case 2:
         qr.rem -= checkIncDecModel(event, qr.rem+2, 1, 62)-2;
         timer->start -= qr.rem ;
         if ((int16_t)timer->start < 0) timer->start=0;
+        timersStates[timerIdx].announce = TIMER_MIN;
         break;
     }
   }
@@ -254,7 +254,7 @@ void displayTopBar()
     if (g_model.frsky.voltsSource) {
       TelemetryItem & voltsItem = telemetryItems[g_model.frsky.voltsSource-1];
       if (voltsItem.isAvailable()) {
-        putsTelemetryChannelValue(batt_icon_x+7*FW+2, BAR_Y+1, g_model.frsky.voltsSource-1, voltsItem.value, LEFT);
+        putsTelemetryChannelValue(batt_icon_x+7*FW+2, BAR_Y+1, g_model.frsky.voltsSource-1, getTelemetrySnapshotValue(g_model.frsky.voltsSource-1).value, LEFT);
         altitude_icon_x = lcdLastPos+1;
       }
     }
@@ -264,7 +264,7 @@ void displayTopBar()
       TelemetryItem & altitudeItem = telemetryItems[g_model.frsky.altitudeSource-1];
       if (altitudeItem.isAvailable()) {
         LCD_ICON(altitude_icon_x, BAR_Y, ICON_ALTITUDE);
-        int32_t value = altitudeItem.value;
+        int32_t value = getTelemetrySnapshotValue(g_model.frsky.altitudeSource-1).value;
         TelemetrySensor & sensor = g_model.telemetrySensors[g_model.frsky.altitudeSource-1];
         if (sensor.prec) value /= sensor.prec == 2 ? 100 : 10;
         putsValueWithUnit(altitude_icon_x+2*FW-1, BAR_Y+1, value, UNIT_METERS, LEFT);
@@ -388,7 +388,7 @@ void onMainViewMenu(const char *result)
     MENU_ADD_ITEM(STR_RESET_TELEMETRY);
   }
   else if (result == STR_RESET_TELEMETRY) {
-    telemetryReset();
+    telemetryRequestReset();
   }
   else if (result == STR_RESET_FLIGHT) {
     flightReset();
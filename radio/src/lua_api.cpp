@@ -649,6 +649,7 @@ static int luaModelSetTimer(lua_State *L)
       }
       else if (!strcmp(key, "value")) {
         timersStates[idx].val = luaL_checkinteger(L, -1);
+        timersStates[idx].announce = TIMER_MIN;
       }
       else if (!strcmp(key, "countdownBeep")) {
         timer.countdownBeep = luaL_checkinteger(L, -1);
@@ -90,7 +90,7 @@ void checkEeprom()
       eeCheck(false);
 #else
     if (theFile.isWriting())
-      theFile.nextWriteStep();
+      theFile.nextRlcWriteStep();
     else if (TIME_TO_WRITE())
       eeCheck(false);
 #endif
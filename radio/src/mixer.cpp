@@ -59,6 +59,21 @@ uint8_t mixWarning;
 
 int16_t calibratedStick[NUM_STICKS+NUM_POTS];
 int16_t channelOutputs[NUM_CHNOUT] = {0};
+#if defined(CPUARM)
+ChannelOutputsFrame channelOutputsFrames[2];
+volatile uint32_t channelOutputsSequence = 0;
+
+void readChannelOutputsFrame(int16_t * destination, uint8_t first, uint8_t count)
+{
+  uint32_t sequence;
+  do {
+    sequence = channelOutputsSequence;
+    __sync_synchronize();
+    memcpy(destination, &channelOutputsFrames[sequence & 1].values[first], count*sizeof(int16_t));
+    __sync_synchronize();
+  } while (sequence != channelOutputsSequence);
+}
+#endif
 int16_t ex_chans[NUM_CHNOUT] = {0}; // Outputs (before LIMITS) of the last perMain;
 
 #if defined(HELI)
@@ -335,7 +350,7 @@ getvalue_t getValue(mixsrc_t i)
   else if (i<=MIXSRC_LAST_TELEM) {
     i -= MIXSRC_FIRST_TELEM;
     div_t qr = div(i, 3);
-    TelemetryItem & telemetryItem = telemetryItems[qr.quot];
+    TelemetrySnapshotValue telemetryItem = getTelemetrySnapshotValue(qr.quot);
     switch (qr.rem) {
       case 1:
         return telemetryItem.valueMin;
@@ -1066,6 +1081,9 @@ void evalMixes(uint8_t tick10ms)
   }
 
   //========== LIMITS ===============
+#if defined(CPUARM)
+  int16_t * nextFrame = channelOutputsFrames[(channelOutputsSequence + 1) & 1].values;
+#endif
   for (uint8_t i=0; i<NUM_CHNOUT; i++) {
     // chans[i] holds data from mixer.   chans[i] = v*weight => 1024*256
     // later we multiply by the limit (up to 100) and then we need to normalize
@@ -1082,11 +1100,22 @@ void evalMixes(uint8_t tick10ms)
 
     int16_t value = applyLimits(i, q);  // applyLimits will remove the 256 100% basis
 
+#if defined(CPUARM)
+    channelOutputs[i] = value;
+    nextFrame[i] = value;
+#else
     cli();
     channelOutputs[i] = value;  // copy consistent word to int-level
     sei();
+#endif
   }
 
+#if defined(CPUARM)
+  // publish the whole frame at once
+  __sync_synchronize();
+  channelOutputsSequence++;
+#endif
+
   if (tick10ms && flightModesFade) {
     uint16_t tick_delta = delta * tick10ms;
     for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
@@ -1334,25 +1334,12 @@ uint16_t anaIn(uint8_t chan)
 #endif
 }
 
-#if defined(CPUARM)
+#if defined(PCBTARANIS)
 void getADC()
 {
-  uint16_t temp[NUMBER_ANALOG] = { 0 };
-
-  for (uint32_t i=0; i<4; i++) {
-    adcRead();
-    for (uint32_t x=0; x<NUMBER_ANALOG; x++) {
-      temp[x] += getAnalogValue(x);
-    }
-#if defined(PCBTARANIS)
-    if (calibrationState) break;
-#endif
-  }
-
+  // the ADC is sampled and filtered in the background, we only read the last values
   for (uint32_t x=0; x<NUMBER_ANALOG; x++) {
-    uint16_t v = temp[x] >> 3;
-#if defined(PCBTARANIS)
-    if (calibrationState) v = temp[x] >> 1;
+    uint16_t v = getAnalogValue(x) / (ADC_OVERSAMPLING*2);
     StepsCalibData * calib = (StepsCalibData *) &g_eeGeneral.calib[x];
     if (!calibrationState && IS_POT_MULTIPOS(x) && calib->count>0 && calib->count<XPOTS_MULTIPOS_COUNT) {
       uint8_t vShifted = (v >> 4);
@@ -1364,9 +1351,25 @@ void getADC()
         }
       }
     }
-    else
-#endif
-    s_anaFilt[x] = v;
+    else {
+      s_anaFilt[x] = v;
+    }
+  }
+}
+#elif defined(CPUARM)
+void getADC()
+{
+  uint16_t temp[NUMBER_ANALOG] = { 0 };
+
+  for (uint32_t i=0; i<4; i++) {
+    adcRead();
+    for (uint32_t x=0; x<NUMBER_ANALOG; x++) {
+      temp[x] += getAnalogValue(x);
+    }
+  }
+
+  for (uint32_t x=0; x<NUMBER_ANALOG; x++) {
+    s_anaFilt[x] = temp[x] >> 3;
   }
 }
 #else
@@ -1514,7 +1517,7 @@ uint8_t trimsDisplayTimer = 0;
 uint8_t trimsDisplayMask = 0;
 #endif
 
-void flightReset()
+void flightReset(bool telemetryPaused)
 {
   // we don't reset the whole audio here (the tada.wav would be cut, if a prompt is queued before FlightReset, it should be played)
   // TODO check if the vario / background music are stopped correctly if switching to a model which doesn't have these functions enabled
@@ -1528,7 +1531,10 @@ void flightReset()
   }
 
 #if defined(FRSKY)
-  telemetryReset();
+  if (telemetryPaused)
+    telemetryReset();
+  else
+    telemetryRequestReset();
 #endif
 
   s_mixer_first_run_done = false;
@@ -1596,10 +1602,6 @@ void doMixerCalculations()
 
   getADC();
 
-#if defined(PCBTARANIS)
-  processSbusInput();
-#endif
-
   getSwitchesPosition(!s_mixer_first_run_done);
 
 #if defined(CPUARM)
@@ -1804,6 +1806,10 @@ uint8_t calcStickScroll( uint8_t index )
 
 void opentxStart()
 {
+#if defined(PCBTARANIS)
+  adcWaitSampled();
+#endif
+
   doSplash();
 
 #if defined(DEBUG_TRACE_BUFFER)
@@ -722,11 +722,31 @@ void logicalSwitchesTimerTick();
 void logicalSwitchesReset();
 
 #if defined(CPUARM)
+  enum LogicalSwitchContextState {
+    SWITCH_START,
+    SWITCH_DELAY,
+    SWITCH_ENABLE
+  };
+
+  PACK(typedef struct {
+    uint8_t state:1;
+    uint8_t timerState:2;
+    uint8_t spare:5;
+    uint8_t timer;
+    int16_t lastValue;
+  }) LogicalSwitchContext;
+
+  PACK(typedef struct {
+    LogicalSwitchContext lsw[NUM_LOGICAL_SWITCH];
+  }) LogicalSwitchesFlightModeContext;
+  extern LogicalSwitchesFlightModeContext lswFm[MAX_FLIGHT_MODES];
+
   void evalLogicalSwitches(bool isCurrentPhase=true);
   void logicalSwitchesCopyState(uint8_t src, uint8_t dst);
   #define LS_RECURSIVE_EVALUATION_RESET()
 #else
   #define evalLogicalSwitches(xxx)
+  extern int16_t lsLastValue[NUM_LOGICAL_SWITCH];
   #define GETSWITCH_RECURSIVE_TYPE uint16_t
   extern volatile GETSWITCH_RECURSIVE_TYPE s_last_switch_used;
   extern volatile GETSWITCH_RECURSIVE_TYPE s_last_switch_value;
@@ -870,7 +890,8 @@ extern uint8_t trimsDisplayTimer;
 extern uint8_t trimsDisplayMask;
 #endif
 
-void flightReset();
+// telemetryPaused: the caller holds the telemetry mutex, the telemetry is reset at once
+void flightReset(bool telemetryPaused=false);
 
 extern uint8_t unexpectedShutdown;
 
@@ -948,7 +969,26 @@ void checkAll();
 #endif
 
 #if defined(PCBTARANIS)
-void processSbusInput();
+#define SBUS_FRAME_SIZE        25
+#define SBUS_DMA_BUFFER_SIZE   (2*SBUS_FRAME_SIZE)
+
+struct SbusDmaRing {
+  uint8_t  buffer[SBUS_DMA_BUFFER_SIZE];
+  uint32_t readIndex;
+};
+
+struct SbusStatistics {
+  uint32_t frames;
+  uint32_t errors;
+  uint32_t lostFrames;
+  uint32_t failsafes;
+};
+
+extern SbusDmaRing sbusDmaRing;
+extern SbusStatistics sbusStatistics;
+
+void processSbusFrame(uint8_t *sbus, int16_t *pulses, uint32_t size);
+void processSbusDmaRing(uint32_t writeIndex, bool error);
 #endif
 
 extern void backlightOn();
@@ -1024,13 +1064,18 @@ extern "C" {
 #endif
 
 extern OS_MutexID mixerMutex;
+extern OS_MutexID telemetryMutex;
+extern OS_FlagID telemetryFlag;
+
 inline void pauseMixerCalculations()
 {
   CoEnterMutexSection(mixerMutex);
+  CoEnterMutexSection(telemetryMutex);
 }
 
 inline void resumeMixerCalculations()
 {
+  CoLeaveMutexSection(telemetryMutex);
   CoLeaveMutexSection(mixerMutex);
 }
 #else
@@ -1112,6 +1157,27 @@ extern int16_t            g_ppmIns[NUM_TRAINER];
 extern int32_t            chans[NUM_CHNOUT];
 extern int16_t            ex_chans[NUM_CHNOUT]; // Outputs (before LIMITS) of the last perMain
 extern int16_t            channelOutputs[NUM_CHNOUT];
+
+#if defined(CPUARM)
+// Channel outputs published once per mixer run for the pulses, trainer and
+// joystick outputs. The mixer fills the frame which is not published, then
+// increments channelOutputsSequence, so readers never see a half-written frame
+struct ChannelOutputsFrame {
+  int16_t values[NUM_CHNOUT];
+};
+extern ChannelOutputsFrame channelOutputsFrames[2];
+extern volatile uint32_t   channelOutputsSequence;
+
+// To be used from interrupt context only (the mixer cannot run meanwhile)
+inline const int16_t * getChannelOutputsFrame()
+{
+  return channelOutputsFrames[channelOutputsSequence & 1].values;
+}
+
+// To be used from tasks which may be preempted by the mixer
+void readChannelOutputsFrame(int16_t * destination, uint8_t first, uint8_t count);
+#endif
+
 extern uint16_t           BandGap;
 
 #if defined(VIRTUALINPUTS)
@@ -1477,6 +1543,10 @@ enum AUDIO_SOUNDS {
 #include "sdcard.h"
 #endif
 
+#if defined(CPUARM) && defined(FRSKY)
+#include "telemetry/recorder.h"
+#endif
+
 #if defined(RTCLOCK)
 #include "rtc.h"
 #endif
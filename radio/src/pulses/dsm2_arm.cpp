@@ -186,8 +186,9 @@ void setupPulsesDSM2(unsigned int port)
 
   dsmDat[1] = g_model.header.modelId; // DSM2 Header second byte for model match
 
+  const int16_t * channels = getChannelOutputsFrame();
   for (int i=0; i<DSM2_CHANS; i++) {
-    uint16_t pulse = limit(0, ((channelOutputs[g_model.moduleData[port].channelsStart+i]*13)>>5)+512, 1023);
+    uint16_t pulse = limit(0, ((channels[g_model.moduleData[port].channelsStart+i]*13)>>5)+512, 1023);
     dsmDat[2+2*i] = (i<<2) | ((pulse>>8)&0x03);
     dsmDat[3+2*i] = pulse & 0xff;
   }
@@ -88,6 +88,23 @@ const uint16_t CRCTable[]=
   0x7bc7,0x6a4e,0x58d5,0x495c,0x3de3,0x2c6a,0x1ef1,0x0f78
 };
 
+// Bit stuffing of one nibble, indexed by the count of consecutive ones already
+// sent (0..4) and the nibble value (MSB first). Each entry holds the parts to
+// send (bits 0-4, MSB first, stuffed zeros included), the number of parts
+// (bits 8-10) and the new count of consecutive ones (bits 12-14)
+const uint16_t PcmStuffingTable[5][16] =
+{
+  { 0x0400, 0x1401, 0x0402, 0x2403, 0x0404, 0x1405, 0x0406, 0x3407, 0x0408, 0x1409, 0x040a, 0x240b, 0x040c, 0x140d, 0x040e, 0x440f },
+  { 0x0400, 0x1401, 0x0402, 0x2403, 0x0404, 0x1405, 0x0406, 0x3407, 0x0408, 0x1409, 0x040a, 0x240b, 0x040c, 0x140d, 0x040e, 0x051e },
+  { 0x0400, 0x1401, 0x0402, 0x2403, 0x0404, 0x1405, 0x0406, 0x3407, 0x0408, 0x1409, 0x040a, 0x240b, 0x040c, 0x140d, 0x051c, 0x151d },
+  { 0x0400, 0x1401, 0x0402, 0x2403, 0x0404, 0x1405, 0x0406, 0x3407, 0x0408, 0x1409, 0x040a, 0x240b, 0x0518, 0x1519, 0x051a, 0x251b },
+  { 0x0400, 0x1401, 0x0402, 0x2403, 0x0404, 0x1405, 0x0406, 0x3407, 0x0510, 0x1511, 0x0512, 0x2513, 0x0514, 0x1515, 0x0516, 0x3517 }
+};
+
+#define PCM_STUFFING_PARTS(x)              ((x) & 0x1F)
+#define PCM_STUFFING_COUNT(x)              (((x) >> 8) & 0x07)
+#define PCM_STUFFING_ONES(x)               ((x) >> 12)
+
 void crc(uint8_t data, unsigned int port)
 {
   PcmCrc[port]=(PcmCrc[port]<<8)^(CRCTable[((PcmCrc[port]>>8)^data) & 0xFF]);
@@ -95,15 +112,19 @@ void crc(uint8_t data, unsigned int port)
 
 #if defined(PCBTARANIS)
 
-void putPcmPart(uint8_t value, unsigned int port)
+// Sends the count last parts (MSB first) of the parts word
+void putPcmParts(uint32_t parts, uint32_t count, unsigned int port)
 {
-  PxxValue[port] += 18 ;                                        // Output 1 for this time
-  *pxxStreamPtr[port]++ = PxxValue[port] ;
-  PxxValue[port] += 14 ;
-  if (value) {
-    PxxValue[port] += 16 ;
+  uint16_t * ptr = pxxStreamPtr[port];
+  uint16_t value = PxxValue[port];
+  while (count--) {
+    value += 18;                                // Output 1 for this time
+    *ptr++ = value;
+    value += ((parts >> count) & 1) ? 30 : 14;  // Output 0 for this time
+    *ptr++ = value;
   }
-  *pxxStreamPtr[port]++ = PxxValue[port] ;  // Output 0 for this time
+  PxxValue[port] = value;
+  pxxStreamPtr[port] = ptr;
 }
 
 void putPcmFlush(unsigned int port)
@@ -113,76 +134,60 @@ void putPcmFlush(unsigned int port)
 
 #else
 
-uint8_t pcmSerialByte[NUM_MODULES];
+uint32_t pcmSerialBits[NUM_MODULES];
 uint8_t pcmSerialBitCount[NUM_MODULES];
-void putPcmSerialBit(uint8_t bit, unsigned int port)
-{
-  pcmSerialByte[port] >>= 1;
-  if (bit & 1) {
-    pcmSerialByte[port] |= 0x80;
-  }
-  if (++pcmSerialBitCount[port] >= 8) {
-    *pxxStreamPtr[port]++ = pcmSerialByte[port];
-    pcmSerialBitCount[port] = 0;
-  }
-}
 
-// 8uS/bit 01 = 0, 001 = 1
-void putPcmPart(uint8_t value, unsigned int port)
+// 8uS/bit 01 = 0, 001 = 1, sent LSB first
+// Sends the count last parts (MSB first) of the parts word
+void putPcmParts(uint32_t parts, uint32_t count, unsigned int port)
 {
-  putPcmSerialBit(0, port);
-  if (value) {
-    putPcmSerialBit(0, port);
+  uint32_t bits = pcmSerialBits[port];
+  uint32_t bitCount = pcmSerialBitCount[port];
+  while (count--) {
+    if ((parts >> count) & 1) {
+      bits |= 0x04 << bitCount;
+      bitCount += 3;
+    }
+    else {
+      bits |= 0x02 << bitCount;
+      bitCount += 2;
+    }
+    if (bitCount >= 8) {
+      *pxxStreamPtr[port]++ = bits;
+      bits >>= 8;
+      bitCount -= 8;
+    }
   }
-  putPcmSerialBit(1, port);
+  pcmSerialBits[port] = bits;
+  pcmSerialBitCount[port] = bitCount;
 }
 
 void putPcmFlush(unsigned int port)
 {
-  while (pcmSerialBitCount[port] != 0) {
-    putPcmSerialBit(1, port);
+  if (pcmSerialBitCount[port] != 0) {
+    *pxxStreamPtr[port]++ = pcmSerialBits[port] | (0xFF << pcmSerialBitCount[port]);
+    pcmSerialBits[port] = 0;
+    pcmSerialBitCount[port] = 0;
   }
 }
 
 #endif
 
-void putPcmBit(uint8_t bit, unsigned int port)
-{
-  if (bit) {
-    PcmOnesCount[port] += 1;
-    putPcmPart(1, port);
-  }
-  else {
-    PcmOnesCount[port] = 0;
-    putPcmPart(0, port);
-  }
-  if (PcmOnesCount[port] >= 5) {
-    putPcmBit(0, port);                                // Stuff a 0 bit in
-  }
-}
-
 void putPcmByte(uint8_t byte, unsigned int port)
 {
   crc(byte, port);
 
-  for (uint8_t i=0; i<8; i++) {
-    putPcmBit(byte & 0x80, port);
-    byte <<= 1;
-  }
+  uint16_t high = PcmStuffingTable[PcmOnesCount[port]][byte >> 4];
+  uint16_t low = PcmStuffingTable[PCM_STUFFING_ONES(high)][byte & 0x0F];
+  PcmOnesCount[port] = PCM_STUFFING_ONES(low);
+  putPcmParts((PCM_STUFFING_PARTS(high) << PCM_STUFFING_COUNT(low)) | PCM_STUFFING_PARTS(low), PCM_STUFFING_COUNT(high) + PCM_STUFFING_COUNT(low), port);
 }
 
 void putPcmHead(unsigned int port)
 {
   // send 7E, do not CRC
   // 01111110
-  putPcmPart(0, port);
-  putPcmPart(1, port);
-  putPcmPart(1, port);
-  putPcmPart(1, port);
-  putPcmPart(1, port);
-  putPcmPart(1, port);
-  putPcmPart(1, port);
-  putPcmPart(0, port);
+  putPcmParts(0x7E, 8, port);
 }
 
 void setupPulsesPXX(unsigned int port)
@@ -195,10 +200,7 @@ void setupPulsesPXX(unsigned int port)
   PcmOnesCount[port] = 0;
 
   /* Preamble */
-  putPcmPart(0, port);
-  putPcmPart(0, port);
-  putPcmPart(0, port);
-  putPcmPart(0, port);
+  putPcmParts(0, 4, port);
 
   /* Sync */
   putPcmHead(port);
@@ -231,6 +233,7 @@ void setupPulsesPXX(unsigned int port)
 
   /* PPM */
   static uint32_t pass[NUM_MODULES] = { MODULES_INIT(0) };
+  const int16_t * channels = getChannelOutputsFrame();
   int sendUpperChannels = 0;
   if (pass[port]++ & 0x01) {
     sendUpperChannels = g_model.moduleData[port].channelsCount;
@@ -252,9 +255,9 @@ void setupPulsesPXX(unsigned int port)
     }
     else {
       if (i < sendUpperChannels)
-        chan = limit(2049, PPM_CH_CENTER(8+g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channelOutputs[8+g_model.moduleData[port].channelsStart+i] * 512 / 682) + 3072, 4094);
+        chan = limit(2049, PPM_CH_CENTER(8+g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channels[8+g_model.moduleData[port].channelsStart+i] * 512 / 682) + 3072, 4094);
       else if (i < NUM_CHANNELS(port))
-        chan = limit(1, PPM_CH_CENTER(g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channelOutputs[g_model.moduleData[port].channelsStart+i] * 512 / 682) + 1024, 2046);
+        chan = limit(1, PPM_CH_CENTER(g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channels[g_model.moduleData[port].channelsStart+i] * 512 / 682) + 1024, 2046);
       else
         chan = 1024;
     }
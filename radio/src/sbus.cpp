@@ -36,59 +36,86 @@
 
 #include "opentx.h"
 
-Fifo<32> sbusFifo;
-uint8_t SbusFrame[28] ;
-uint16_t SbusTimer ;
-uint8_t SbusIndex = 0 ;
+SbusStatistics sbusStatistics;
+SbusDmaRing sbusDmaRing;
+
+#define SBUS_START_BYTE        0x0F
+#define SBUS_FLAGS_INDEX       23
+#define SBUS_FRAME_LOST_BIT    0x04
+#define SBUS_FAILSAFE_BIT      0x08
+
+#define SBUS_CHANNEL(x)        (((int32_t)((x) & 0x7FF) - 0x3E0) * 5 / 8)
 
 void processSbusFrame(uint8_t *sbus, int16_t *pulses, uint32_t size)
 {
-  uint32_t inputbitsavailable = 0;
-  uint32_t inputbits = 0;
-
-  if (*sbus++ != 0x0F) {
+  if (sbus[0] != SBUS_START_BYTE || size < 23) {
+    sbusStatistics.errors++;
     return; // not a valid SBUS frame
   }
 
-  if (size < 23) {
-    return;
-  }
+  sbusStatistics.frames++;
 
-  for (uint32_t i=0; i<NUM_TRAINER; i++) {
-    while (inputbitsavailable < 11) {
-      inputbits |= *sbus++ << inputbitsavailable;
-      inputbitsavailable += 8;
+  if (size > SBUS_FLAGS_INDEX) {
+    uint8_t flags = sbus[SBUS_FLAGS_INDEX];
+    if (flags & SBUS_FRAME_LOST_BIT) {
+      sbusStatistics.lostFrames++;
+    }
+    if (flags & SBUS_FAILSAFE_BIT) {
+      // the receiver outputs its failsafe values, let the trainer input time out
+      sbusStatistics.failsafes++;
+      return;
     }
-    *pulses++ = ((int32_t) (inputbits & 0x7FF) - 0x3E0) * 5 / 8;
-    inputbitsavailable -= 11;
-    inputbits >>= 11;
+  }
+
+  // each block of 11 bytes holds 8 channels of 11 bits
+  const uint8_t * data = sbus + 1;
+  for (uint32_t i=0; i<NUM_TRAINER; i+=8) {
+    uint32_t w0 = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+    uint32_t w1 = data[4] | (data[5] << 8) | (data[6] << 16) | ((uint32_t)data[7] << 24);
+    uint32_t w2 = data[8] | (data[9] << 8) | (data[10] << 16);
+    pulses[0] = SBUS_CHANNEL(w0);
+    pulses[1] = SBUS_CHANNEL(w0 >> 11);
+    pulses[2] = SBUS_CHANNEL((w0 >> 22) | (w1 << 10));
+    pulses[3] = SBUS_CHANNEL(w1 >> 1);
+    pulses[4] = SBUS_CHANNEL(w1 >> 12);
+    pulses[5] = SBUS_CHANNEL((w1 >> 23) | (w2 << 9));
+    pulses[6] = SBUS_CHANNEL(w2 >> 2);
+    pulses[7] = SBUS_CHANNEL(w2 >> 13);
+    pulses += 8;
+    data += 11;
   }
 
   ppmInValid = PPM_IN_VALID_TIMEOUT;
 }
 
-#define SBUS_DELAY 1000 // 500uS
-void processSbusInput()
+// Called from the USART idle line interrupt: the bytes received by the DMA
+// since the previous call form one frame. The ring holds exactly 2 frames, so
+// as long as no byte is lost, frames are decoded in place
+void processSbusDmaRing(uint32_t writeIndex, bool error)
 {
-  uint8_t rxchar;
-  uint32_t active = 0;
-  while (sbusFifo.pop(rxchar)) {
-    active = 1;
-    SbusFrame[SbusIndex++] = rxchar;
-    if (SbusIndex > 27) {
-      SbusIndex = 27;
-    }
+  uint32_t readIndex = sbusDmaRing.readIndex;
+  uint32_t size = (writeIndex + SBUS_DMA_BUFFER_SIZE - readIndex) % SBUS_DMA_BUFFER_SIZE;
+
+  sbusDmaRing.readIndex = writeIndex;
+
+  if (size == 0) {
+    return;
   }
-  if (active) {
-    SbusTimer = getTmr2MHz();
+
+  // a frame truncated by an idle line break is dropped as well
+  if (error || size != SBUS_FRAME_SIZE) {
+    sbusStatistics.errors++;
     return;
   }
-  else {
-    if (SbusIndex) {
-      if ((uint16_t) (getTmr2MHz() - SbusTimer) > SBUS_DELAY) {
-        processSbusFrame(SbusFrame, g_ppmIns, SbusIndex);
-        SbusIndex = 0;
-      }
-    }
+
+  uint8_t * frame = &sbusDmaRing.buffer[readIndex];
+  uint8_t linear[SBUS_FRAME_SIZE];
+  if (readIndex + size > SBUS_DMA_BUFFER_SIZE) {
+    uint32_t first = SBUS_DMA_BUFFER_SIZE - readIndex;
+    memcpy(linear, frame, first);
+    memcpy(&linear[first], sbusDmaRing.buffer, size - first);
+    frame = linear;
   }
+
+  processSbusFrame(frame, g_ppmIns, size);
 }
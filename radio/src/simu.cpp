@@ -328,7 +328,6 @@ long Open9xSim::onTimeout(FXObject*, FXSelector, void*)
 #endif
   }
 
-  per10ms();
   refreshDisplay();
   getApp()->addTimeout(this, 2, 10);
   return 0;
@@ -351,9 +350,10 @@ void Open9xSim::setPixel(int x, int y, FXColor color)
 
 void Open9xSim::refreshDisplay()
 {
-  if (lcd_refresh) {
-    lcd_refresh = false;
-    FXColor offColor = IS_BACKLIGHT_ON() ? BL_COLOR : FXRGB(200, 200, 200);
+  bool light;
+  if (simuPopFrame(light)) {
+    while (simuPopFrame(light)); // only the latest frame is displayed
+    FXColor offColor = light ? BL_COLOR : FXRGB(200, 200, 200);
 #if LCD_W == 128
     FXColor onColor = FXRGB(0, 0, 0);
 #endif
@@ -364,7 +364,7 @@ void Open9xSim::refreshDisplay()
         uint8_t z = (y & 1) ? (*p >> 4) : (*p & 0x0F);
         if (z) {
           FXColor color;
-          if (IS_BACKLIGHT_ON())
+          if (light)
             color = FXRGB(47-(z*47)/15, 123-(z*123)/15, 227-(z*227)/15);
           else
             color = FXRGB(200-(z*200)/15, 200-(z*200)/15, 200-(z*200)/15);
@@ -435,6 +435,16 @@ int main(int argc,char **argv)
   printf("Model size = %d\n", (int)sizeof(g_model));
 
   StartEepromThread(argc >= 2 ? argv[1] : "eeprom.bin");
+
+#if defined(CPUARM) && defined(FRSKY)
+  // simu [eeprom.bin [telemetry.tlm [speed]]]
+  if (argc >= 3 && !telemetryReplay.open(argv[2])) {
+    printf("Cannot replay the telemetry record %s\n", argv[2]);
+  }
+  if (argc >= 4) {
+    telemetryReplay.speed = atoi(argv[3]);
+  }
+#endif
   StartAudioThread();
   StartMainThread();
 
@@ -40,23 +40,6 @@
 
 #if defined(CPUARM)
 
-enum LogicalSwitchContextState {
-  SWITCH_START,
-  SWITCH_DELAY,
-  SWITCH_ENABLE
-};
-
-PACK(typedef struct {
-  uint8_t state:1;
-  uint8_t timerState:2;
-  uint8_t spare:5;
-  uint8_t timer;
-  int16_t lastValue;
-}) LogicalSwitchContext;
-
-PACK(typedef struct {
-  LogicalSwitchContext lsw[NUM_LOGICAL_SWITCH];
-}) LogicalSwitchesFlightModeContext;
 LogicalSwitchesFlightModeContext lswFm[MAX_FLIGHT_MODES];
 
 #define LS_LAST_VALUE(fm, idx) lswFm[fm].lsw[idx].lastValue
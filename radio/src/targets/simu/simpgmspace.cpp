@@ -35,6 +35,7 @@
  */
 
 #include "opentx.h"
+#include "timers.h"
 #include <errno.h>
 #include <fcntl.h>
 #include <stdarg.h>
@@ -47,6 +48,13 @@
   #include <direct.h>
 #endif
 
+#if !defined WIN32
+  #include <sys/mman.h>
+  #include <sys/time.h>
+#else
+  #include <windows.h>
+#endif
+
 #if defined(SIMU_DISKIO)
   FILE * diskImage = 0;
 #endif
@@ -59,15 +67,15 @@ volatile uint8_t pina=0xff, pinb=0xff, pinc=0xff, pind, pine=0xff, pinf=0xff, pi
 uint8_t portb, portc, porth=0, dummyport;
 uint16_t dummyport16;
 const char *eepromFile = NULL;
-FILE *fp = NULL;
+bool eeprom_fast_storage = false;
 
 #if defined(CPUSTM32)
 uint32_t Peri1_frequency, Peri2_frequency;
 GPIO_TypeDef gpioa, gpiob, gpioc, gpiod, gpioe, gpiof, gpiog;
 TIM_TypeDef tim1, tim2, tim3, tim4, tim5, tim6, tim7, tim8, tim9, tim10;
 RCC_TypeDef rcc;
-DMA_Stream_TypeDef dma2_stream2, dma2_stream6;
-DMA_TypeDef dma2;
+DMA_Stream_TypeDef dma1_stream1, dma2_stream1, dma2_stream2, dma2_stream6;
+DMA_TypeDef dma1, dma2;
 USART_TypeDef Usart0, Usart1, Usart2, Usart3, Usart4;
 #elif defined(CPUARM)
 Pio Pioa, Piob, Pioc;
@@ -76,6 +84,7 @@ Twi Twio;
 Usart Usart0;
 Dacc dacc;
 Adc Adc0;
+Tc tc1;
 #endif
 
 #if defined(PCBSKY9X)
@@ -98,6 +107,7 @@ char simuSdDirectory[1024] = "";
 #endif
 
 uint8_t eeprom[EESIZE_SIMU];
+uint8_t * eeprom_storage = eeprom; // eeprom[] or the mapped eepromFile
 sem_t *eeprom_write_sem;
 
 #if defined(CPUARM)
@@ -277,29 +287,24 @@ void *eeprom_write_function(void *)
     }
     else {
 #endif
-    if (fp) {
-      if (fseek(fp, eeprom_pointer, SEEK_SET) == -1)
-        perror("error in fseek");
-    }
-    while (--eeprom_buffer_size) {
-      assert(eeprom_buffer_size > 0);
-      if (fp) {
-        if (fwrite(eeprom_buffer_data, 1, 1, fp) != 1)
-          perror("error in fwrite");
 #if !defined(CPUARM)
+    if (eepromFile && !eeprom_fast_storage) {
+      // the AVR EEPROM takes 5ms per byte
+      while (--eeprom_buffer_size) {
+        assert(eeprom_buffer_size > 0);
+        eeprom_storage[eeprom_pointer++] = *eeprom_buffer_data++;
         sleep(5/*ms*/);
-#endif
-      }
-      else {
-        memcpy(&eeprom[eeprom_pointer], eeprom_buffer_data, 1);
-      }
-      eeprom_pointer++;
-      eeprom_buffer_data++;
-      
-      if (fp && eeprom_buffer_size == 1) {
-        fflush(fp);
       }
     }
+    else
+#endif
+    {
+      assert(eeprom_buffer_size > 0);
+      memcpy(&eeprom_storage[eeprom_pointer], eeprom_buffer_data, eeprom_buffer_size-1);
+      eeprom_pointer += eeprom_buffer_size-1;
+      eeprom_buffer_data += eeprom_buffer_size-1;
+      eeprom_buffer_size = 0;
+    }
 #if defined(CPUARM)
     }
     Spi_complete = 1;
@@ -311,6 +316,57 @@ void *eeprom_write_function(void *)
 
 uint8_t main_thread_running = 0;
 char * main_thread_error = NULL;
+uint8_t simu_speed = 1;
+pthread_mutex_t simuStateMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Holds simuStateMutex until the end of the scope, also when an exception leaves it
+struct SimuStateLock {
+  SimuStateLock() { pthread_mutex_lock(&simuStateMutex); }
+  ~SimuStateLock() { pthread_mutex_unlock(&simuStateMutex); }
+};
+
+// The main thread owns the simulated time: each loop is exactly one 10ms tick,
+// the wall clock is only used to pace the loops according to simu_speed
+uint32_t simuWallTime()
+{
+#if defined(WIN32)
+  return GetTickCount();
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+void simuWaitNextTick()
+{
+  static uint8_t speed = 0;
+  static uint32_t start;
+  static uint32_t ticks;
+
+  if (simu_speed == 0) {
+    speed = 0;
+    return;
+  }
+
+  uint32_t now = simuWallTime();
+  if (speed != simu_speed) {
+    speed = simu_speed;
+    start = now;
+    ticks = 0;
+  }
+
+  int32_t delay = (int32_t)(start + (++ticks) * 10 / speed - now);
+  if (delay > 0) {
+    sleep(delay/*ms*/);
+  }
+  else if (delay < -100) {
+    // the process was stalled, don't try to catch up
+    start = now;
+    ticks = 0;
+  }
+}
+
 extern void opentxStart();
 void *main_thread(void *)
 {
@@ -357,15 +413,22 @@ void *main_thread(void *)
     s_current_protocol[0] = 0;
 
     while (main_thread_running) {
+      {
+        SimuStateLock lock;
+        per10ms();
 #if defined(CPUARM)
-      doMixerCalculations();
+        doMixerCalculations();
+#if defined(FRSKY)
+        telemetryReplay.wakeup();
+#endif
 #if defined(FRSKY) || defined(MAVLINK)
-      telemetryWakeup();
+        telemetryWakeup();
 #endif
-      checkTrims();
+        checkTrims();
 #endif
-      perMain();
-      sleep(10/*ms*/);
+        perMain();
+      }
+      simuWaitNextTick();
     }
 
 #if defined(LUA)
@@ -394,6 +457,20 @@ void *main_thread(void *)
 #endif
 
 pthread_t main_thread_pid;
+
+// The main thread waiting inside one of its steps (splash, startup
+// warnings, ...) keeps the virtual clock running, or these loops which
+// wait for get_tmr10ms() would never time out
+void simuSleep(uint32_t ms)
+{
+  static uint32_t elapsed = 0;
+  sleep(ms);
+  if (pthread_equal(pthread_self(), main_thread_pid)) {
+    for (elapsed += ms; elapsed >= 10; elapsed -= 10) {
+      per10ms();
+    }
+  }
+}
 void StartMainThread(bool tests)
 {
 #if defined(SDCARD)
@@ -403,6 +480,7 @@ void StartMainThread(bool tests)
 
 #if defined(CPUARM)
   pthread_mutex_init(&mixerMutex, NULL);
+  pthread_mutex_init(&telemetryMutex, NULL);
   pthread_mutex_init(&audioMutex, NULL);
 #endif
 
@@ -421,6 +499,110 @@ void StopMainThread()
   pthread_join(main_thread_pid, NULL);
 }
 
+// The firmware state which is saved in a snapshot. The static variables local
+// to a function (flight modes fading, filters) are not part of it, neither is
+// the menus state. The Lua interpreter is restarted on restore
+struct SimuStateRegion {
+  void * data;
+  uint32_t size;
+};
+
+#define SIMU_STATE_REGION(x) { (void *)&(x), sizeof(x) }
+
+extern int32_t sum_chans512[NUM_CHNOUT];
+#if defined(CPUARM)
+extern tmr10ms_t flightModeTransitionTime;
+#endif
+#if defined(PCBTARANIS)
+extern tmr10ms_t switchesMidposStart[6];
+extern uint64_t switchesPos;
+extern tmr10ms_t potsLastposStart[NUM_XPOTS];
+extern uint8_t potsPos[NUM_XPOTS];
+#endif
+
+const SimuStateRegion simuStateRegions[] = {
+  SIMU_STATE_REGION(g_eeGeneral),
+  SIMU_STATE_REGION(g_model),
+  SIMU_STATE_REGION(g_tmr10ms),
+#if defined(RTCLOCK)
+  SIMU_STATE_REGION(g_rtcTime),
+#endif
+  SIMU_STATE_REGION(anas),
+  SIMU_STATE_REGION(trims),
+  SIMU_STATE_REGION(chans),
+  SIMU_STATE_REGION(ex_chans),
+  SIMU_STATE_REGION(sum_chans512),
+  SIMU_STATE_REGION(channelOutputs),
+  SIMU_STATE_REGION(calibratedStick),
+  SIMU_STATE_REGION(swOn),
+  SIMU_STATE_REGION(act),
+  SIMU_STATE_REGION(safetyCh),
+  SIMU_STATE_REGION(bpanaCenter),
+  SIMU_STATE_REGION(mixWarning),
+  SIMU_STATE_REGION(s_mixer_first_run_done),
+  SIMU_STATE_REGION(mixerCurrentFlightMode),
+  SIMU_STATE_REGION(lastFlightMode),
+#if defined(CPUARM)
+  SIMU_STATE_REGION(flightModeTransitionTime),
+  SIMU_STATE_REGION(flightModeTransitionLast),
+  SIMU_STATE_REGION(lswFm),
+  SIMU_STATE_REGION(globalFunctionsContext),
+#else
+  SIMU_STATE_REGION(lsLastValue),
+#endif
+  SIMU_STATE_REGION(modelFunctionsContext),
+  SIMU_STATE_REGION(switches_states),
+#if defined(PCBTARANIS)
+  SIMU_STATE_REGION(switchesMidposStart),
+  SIMU_STATE_REGION(switchesPos),
+  SIMU_STATE_REGION(potsLastposStart),
+  SIMU_STATE_REGION(potsPos),
+#endif
+  SIMU_STATE_REGION(timersStates),
+  SIMU_STATE_REGION(sessionTimer),
+  SIMU_STATE_REGION(s_timeCumThr),
+  SIMU_STATE_REGION(s_timeCum16ThrP),
+  SIMU_STATE_REGION(g_ppmIns),
+  SIMU_STATE_REGION(ppmInValid),
+#if defined(FRSKY)
+  SIMU_STATE_REGION(frskyData),
+  SIMU_STATE_REGION(frskyStreaming),
+#endif
+#if defined(CPUARM) && defined(FRSKY)
+  SIMU_STATE_REGION(telemetryItems),
+#endif
+};
+
+uint32_t simuStateSize()
+{
+  uint32_t size = 0;
+  for (unsigned int i=0; i<DIM(simuStateRegions); i++) {
+    size += simuStateRegions[i].size;
+  }
+  return size;
+}
+
+void simuSaveState(uint8_t * state)
+{
+  SimuStateLock lock;
+  for (unsigned int i=0; i<DIM(simuStateRegions); i++) {
+    memcpy(state, simuStateRegions[i].data, simuStateRegions[i].size);
+    state += simuStateRegions[i].size;
+  }
+}
+
+void simuRestoreState(const uint8_t * state)
+{
+  SimuStateLock lock;
+  for (unsigned int i=0; i<DIM(simuStateRegions); i++) {
+    memcpy(simuStateRegions[i].data, state, simuStateRegions[i].size);
+    state += simuStateRegions[i].size;
+  }
+#if defined(LUA)
+  LUA_LOAD_MODEL_SCRIPTS();
+#endif
+}
+
 #if defined(CPUARM)
 int Volume = volumeScale[VOLUME_LEVEL_DEF];
 bool dacQueue(AudioBuffer *buffer)
@@ -548,11 +730,31 @@ pthread_t eeprom_thread_pid;
 void StartEepromThread(const char *filename)
 {
   eepromFile = filename;
+  eeprom_storage = eeprom;
   if (eepromFile) {
-    fp = fopen(eepromFile, "rb+");
-    if (!fp)
-      fp = fopen(eepromFile, "wb+");
-    if (!fp) perror("error in fopen");
+#if defined WIN32
+    // no mmap, the file is written back by StopEepromThread()
+    memset(eeprom, 0, EESIZE_SIMU);
+    FILE * fp = fopen(eepromFile, "rb");
+    if (fp) {
+      if (fread(eeprom, 1, EESIZE_SIMU, fp) <= 0) perror("error in fread");
+      fclose(fp);
+    }
+#else
+    struct stat st;
+    int fd = open(eepromFile, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    if (fd < 0 || fstat(fd, &st) < 0 || (st.st_size < EESIZE_SIMU && ftruncate(fd, EESIZE_SIMU) < 0)) {
+      perror("error in open");
+    }
+    else {
+      void * storage = mmap(NULL, EESIZE_SIMU, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (storage == MAP_FAILED)
+        perror("error in mmap");
+      else
+        eeprom_storage = (uint8_t *)storage;
+    }
+    if (fd >= 0) close(fd);
+#endif
   }
 #ifdef __APPLE__
   eeprom_write_sem = sem_open("eepromsem", O_CREAT, S_IRUSR | S_IWUSR, 0);
@@ -581,7 +783,19 @@ void StopEepromThread()
   free(eeprom_write_sem);
 #endif
 
-  if (fp) fclose(fp);
+#if defined WIN32
+  if (eepromFile) {
+    FILE * fp = fopen(eepromFile, "wb");
+    if (!fp || fwrite(eeprom, EESIZE_SIMU, 1, fp) != 1) perror("error in fwrite");
+    if (fp) fclose(fp);
+  }
+#else
+  if (eeprom_storage != eeprom) {
+    msync(eeprom_storage, EESIZE_SIMU, MS_SYNC);
+    munmap(eeprom_storage, EESIZE_SIMU);
+  }
+#endif
+  eeprom_storage = eeprom;
 }
 
 #if defined(PCBTARANIS)
@@ -592,29 +806,20 @@ void eeprom_read_block (void *pointer_ram, const void *pointer_eeprom, size_t si
 {
   assert(size);
 
-  if (fp) {
-    // TRACE("EEPROM read (pos=%d, size=%d)", pointer_eeprom, size);
-    if (fseek(fp, (long)pointer_eeprom, SEEK_SET)==-1) perror("error in fseek");
-    if (fread(pointer_ram, size, 1, fp) <= 0) perror("error in fread");
-  }
-  else {
-    memcpy(pointer_ram, &eeprom[(uint64_t)pointer_eeprom], size);
-  }
+  memcpy(pointer_ram, &eeprom_storage[(uint64_t)pointer_eeprom], size);
 }
 
 #if defined(PCBTARANIS)
+#define EEPROM_PAGESIZE 64
+uint32_t eeprom_pages_written = 0; // each page takes ~5ms to program on the radio
+
 void eeWriteBlockCmp(const void *pointer_ram, uint16_t pointer_eeprom, size_t size)
 {
   assert(size);
 
-  if (fp) {
-    // TRACE("EEPROM write (pos=%d, size=%d)", pointer_eeprom, size);
-    if (fseek(fp, (long)pointer_eeprom, SEEK_SET)==-1) perror("error in fseek");
-    if (fwrite(pointer_ram, size, 1, fp) <= 0) perror("error in fwrite");
-  }
-  else {
-    memcpy(&eeprom[(uint64_t)pointer_eeprom], pointer_ram, size);
-  }
+  eeprom_pages_written += (pointer_eeprom + size - 1) / EEPROM_PAGESIZE - pointer_eeprom / EEPROM_PAGESIZE + 1;
+
+  memcpy(&eeprom_storage[(uint64_t)pointer_eeprom], pointer_ram, size);
 }
 
 #endif
@@ -1134,6 +1339,49 @@ uint32_t sdGetSpeed()
 bool lcd_refresh = true;
 display_t lcd_buf[DISPLAY_BUF_SIZE];
 
+// Frames rendered by the main thread, waiting to be displayed by the GUI. When
+// the GUI is late the oldest frame is dropped
+struct SimuFrame {
+  bool light;
+  display_t lcd[DISPLAY_BUF_SIZE];
+};
+
+#define SIMU_FRAMES_QUEUE_SIZE 4
+SimuFrame simuFrames[SIMU_FRAMES_QUEUE_SIZE];
+uint8_t simuFramesHead = 0;
+uint8_t simuFramesCount = 0;
+pthread_mutex_t simuFramesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void simuPushFrame()
+{
+  pthread_mutex_lock(&simuFramesMutex);
+  if (simuFramesCount == SIMU_FRAMES_QUEUE_SIZE) {
+    simuFramesHead = (simuFramesHead + 1) % SIMU_FRAMES_QUEUE_SIZE;
+    simuFramesCount--;
+  }
+  SimuFrame & frame = simuFrames[(simuFramesHead + simuFramesCount) % SIMU_FRAMES_QUEUE_SIZE];
+  frame.light = IS_BACKLIGHT_ON();
+  memcpy(frame.lcd, displayBuf, sizeof(frame.lcd));
+  simuFramesCount++;
+  pthread_mutex_unlock(&simuFramesMutex);
+}
+
+bool simuPopFrame(bool & light)
+{
+  bool result = false;
+  pthread_mutex_lock(&simuFramesMutex);
+  if (simuFramesCount > 0) {
+    SimuFrame & frame = simuFrames[simuFramesHead];
+    light = frame.light;
+    memcpy(lcd_buf, frame.lcd, sizeof(lcd_buf));
+    simuFramesHead = (simuFramesHead + 1) % SIMU_FRAMES_QUEUE_SIZE;
+    simuFramesCount--;
+    result = true;
+  }
+  pthread_mutex_unlock(&simuFramesMutex);
+  return result;
+}
+
 void lcdSetRefVolt(uint8_t val)
 {
 }
@@ -1146,8 +1394,13 @@ void lcdOff()
 
 void lcdRefresh()
 {
-  memcpy(lcd_buf, displayBuf, sizeof(lcd_buf));
-  lcd_refresh = true;
+  if (main_thread_running) {
+    simuPushFrame();
+  }
+  else {
+    memcpy(lcd_buf, displayBuf, sizeof(lcd_buf));
+    lcd_refresh = true;
+  }
 }
 
 #if defined(PCBTARANIS)
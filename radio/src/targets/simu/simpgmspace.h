@@ -103,8 +103,8 @@ extern GPIO_TypeDef gpioa, gpiob, gpioc, gpiod, gpioe, gpiof, gpiog;
 extern TIM_TypeDef tim1, tim2, tim3, tim4, tim5, tim6, tim7, tim8, tim9, tim10;
 extern USART_TypeDef Usart0, Usart1, Usart2, Usart3, Usart4;
 extern RCC_TypeDef rcc;
-extern DMA_Stream_TypeDef dma2_stream2, dma2_stream6;
-extern DMA_TypeDef dma2;
+extern DMA_Stream_TypeDef dma1_stream1, dma2_stream1, dma2_stream2, dma2_stream6;
+extern DMA_TypeDef dma1, dma2;
 #undef GPIOA
 #undef GPIOB
 #undef GPIOC
@@ -149,10 +149,16 @@ extern DMA_TypeDef dma2;
 #define USART3 (&Usart3)
 #undef RCC
 #define RCC (&rcc)
+#undef DMA1_Stream1
+#undef DMA2_Stream1
 #undef DMA2_Stream2
 #undef DMA2_Stream6
+#define DMA1_Stream1 (&dma1_stream1)
+#define DMA2_Stream1 (&dma2_stream1)
 #define DMA2_Stream2 (&dma2_stream2)
 #define DMA2_Stream6 (&dma2_stream6)
+#undef DMA1
+#define DMA1 (&dma1)
 #undef DMA2
 #define DMA2 (&dma2)
 #elif defined(PCBSKY9X)
@@ -184,6 +190,9 @@ extern Adc Adc0;
 extern Pwm pwm;
 #undef PWM
 #define PWM (&pwm)
+extern Tc tc1;
+#undef TC1
+#define TC1 (&tc1)
 #endif
 
 extern sem_t *eeprom_write_sem;
@@ -358,16 +367,23 @@ extern volatile unsigned char pina, pinb, pinc, pind, pine, pinf, ping, pinh, pi
 extern uint8_t portb, portc, porth, dummyport;
 extern uint16_t dummyport16;
 extern uint8_t main_thread_running;
+#define SIMU_VIRTUAL_CLOCK // the main thread drives per10ms(), the GUI pops the frames
+extern uint8_t simu_speed; // simulated time multiplier, 0 = as fast as possible
 
 #define getADC()
 #define getADC_bandgap()
 
-#define SIMU_SLEEP(x) do { if (!main_thread_running) return; sleep(x/*ms*/); } while (0)
-#define SIMU_SLEEP_NORET(x) do { sleep(x/*ms*/); } while (0)
+void simuSleep(uint32_t ms);
+#define SIMU_SLEEP(x) do { if (!main_thread_running) return; simuSleep(x/*ms*/); } while (0)
+#define SIMU_SLEEP_NORET(x) do { simuSleep(x/*ms*/); } while (0)
 
 void simuSetKey(uint8_t key, bool state);
 void simuSetTrim(uint8_t trim, bool state);
 void simuSetSwitch(uint8_t swtch, int8_t state);
+bool simuPopFrame(bool & light);
+uint32_t simuStateSize();
+void simuSaveState(uint8_t * state);
+void simuRestoreState(const uint8_t * state);
 
 void StartMainThread(bool tests=true);
 void StopMainThread();
@@ -382,6 +398,7 @@ void StopEepromThread();
 #endif
 
 extern const char *eepromFile;
+extern bool eeprom_fast_storage; // no emulated write latency
 #if defined(PCBTARANIS)
 void eeprom_read_block (void *pointer_ram, uint16_t pointer_eeprom, size_t size);
 #else
@@ -225,8 +225,6 @@ uint32_t btStatus;
 
 void btTask(void* pdata)
 {
-  uint8_t byte;
-
   btFlag = CoCreateFlag(true, false);
   btTx.size = 0;
 
@@ -272,9 +270,10 @@ void btTask(void* pdata)
     uint32_t x = CoWaitForSingleFlag(btFlag, 10); // Wait for data in Fifo
     if (x == E_OK) {
       // We have some data in the Fifo
-      while (btTxFifo.pop(byte)) {
-        btTxBuffer[btTx.size++] = byte;
-        if (btTx.size > 31) {
+      uint32_t count;
+      while ((count = btTxFifo.read(&btTxBuffer[btTx.size], sizeof(btTxBuffer) - btTx.size)) > 0) {
+        btTx.size += count;
+        if (btTx.size == sizeof(btTxBuffer)) {
           btSendBuffer();
         }
       }
@@ -288,6 +288,7 @@ void rotencEnd();
 
 // Debug driver
 void debugPutc(const char c);
+void debugWrite(const char * data, uint32_t len);
 
 // Telemetry driver
 void telemetryPortInit(uint32_t baudrate);
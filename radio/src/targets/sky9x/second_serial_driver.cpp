@@ -64,6 +64,14 @@ void debugPutc(const char c)
   pUart->UART_THR = c;
 }
 
+// the debug port is polled, there is no fifo to fill in one go
+void debugWrite(const char * data, uint32_t len)
+{
+  while (len--) {
+    debugPutc(*data++);
+  }
+}
+
 /**
  * Configures a UART peripheral with the specified parameters.
  *
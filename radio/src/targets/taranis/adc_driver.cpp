@@ -59,9 +59,14 @@
 #endif
 
 // Sample time should exceed 1uS
-#define SAMPTIME    2   // sample time = 28 cycles
+#define SAMPTIME    7   // sample time = 480 cycles, 16uS per channel
 
+// The ADCs scan continuously into circular DMA buffers holding two halves of
+// ADC_OVERSAMPLING scans. Each time a half is completed, its scans are summed
+// and filtered in the DMA interrupt (about every 1.3ms)
 uint16_t Analog_values[NUMBER_ANALOG];
+AdcFilterState adcFilters[NUMBER_ANALOG];
+volatile bool adcSampled = false; // Analog_values hold zeros until the first half is filtered
 
 #if defined(REV9E)
   const int8_t ana_direction[NUMBER_ANALOG] = {1,-1,1,-1,  -1,1,-1,  -1,1,  1,  -1,-1,1};
@@ -91,6 +96,81 @@ uint16_t Analog_values[NUMBER_ANALOG];
                                                  9 /*TX_VOLTAGE*/ };
 #endif
 
+uint16_t adc1Samples[2*ADC_OVERSAMPLING][NUMBER_ANALOG_ADC1];
+#if defined(REV9E)
+uint16_t adc3Samples[2*ADC_OVERSAMPLING][NUMBER_ANALOG_ADC3];
+#endif
+
+uint16_t adcFilter(AdcFilterState & state, uint16_t value)
+{
+  if (!state.initialized) {
+    for (uint8_t i=0; i<ADC_FILTER_HISTORY; i++) {
+      state.history[i] = value;
+    }
+    state.accumulator = value << ADC_FILTER_ONE_POLE_SHIFT;
+    state.initialized = 1;
+  }
+
+  state.index = (state.index + 1) % ADC_FILTER_HISTORY;
+  state.history[state.index] = value;
+
+  switch (state.mode) {
+    case ADC_FILTER_MOVING_AVERAGE:
+    {
+      uint32_t sum = 0;
+      for (uint8_t i=0; i<ADC_FILTER_HISTORY; i++) {
+        sum += state.history[i];
+      }
+      return sum / ADC_FILTER_HISTORY;
+    }
+
+    case ADC_FILTER_ONE_POLE:
+      state.accumulator += value - (state.accumulator >> ADC_FILTER_ONE_POLE_SHIFT);
+      return state.accumulator >> ADC_FILTER_ONE_POLE_SHIFT;
+
+    case ADC_FILTER_MEDIAN:
+    {
+      // median of the 3 last values
+      uint16_t a = state.history[state.index];
+      uint16_t b = state.history[(state.index + ADC_FILTER_HISTORY - 1) % ADC_FILTER_HISTORY];
+      uint16_t c = state.history[(state.index + ADC_FILTER_HISTORY - 2) % ADC_FILTER_HISTORY];
+      if (a > b) {
+        uint16_t tmp = a; a = b; b = tmp;
+      }
+      return (c <= a ? a : (c >= b ? b : c));
+    }
+
+    default:
+      return value;
+  }
+}
+
+void adcSetFilter(uint8_t index, uint8_t mode)
+{
+  adcFilters[index].mode = mode;
+}
+
+// Sums the given half of a circular buffer and stores the filtered results
+void adcFilterSamples(const uint16_t * samples, uint32_t count, uint32_t first)
+{
+  for (uint32_t i=0; i<count; i++) {
+    uint32_t sum = 0;
+    for (uint32_t scan=0; scan<ADC_OVERSAMPLING; scan++) {
+      sum += samples[scan*count + i];
+    }
+    uint32_t index = first + i;
+    if (ana_direction[index] < 0) {
+      sum = ADC_OVERSAMPLING*4096 - sum;
+    }
+#if !defined(REVPLUS)
+    else if (ana_direction[index] == 0) {
+      sum = 0;
+    }
+#endif
+    Analog_values[index] = adcFilter(adcFilters[index], sum);
+  }
+}
+
 void adcInit()
 {
   RCC->APB2ENR |= RCC_APB2ENR_ADC1EN;            // Enable clock
@@ -110,8 +190,12 @@ void adcInit()
 
   configure_pins(PIN_SLD_J1 | PIN_SLD_J2 | PIN_MVOLT, PIN_ANALOG | PIN_PORTC);
 
+  for (uint32_t i=0; i<NUMBER_ANALOG; i++) {
+    adcFilters[i].mode = (i < NUM_STICKS ? ADC_FILTER_NONE : (i == TX_VOLTAGE ? ADC_FILTER_MEDIAN : ADC_FILTER_ONE_POLE));
+  }
+
   ADC1->CR1 = ADC_CR1_SCAN;
-  ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS;
+  ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_CONT;
   ADC1->SQR1 = (NUMBER_ANALOG_ADC1-1) << 20 ; // bits 23:20 = number of conversions
   ADC1->SQR2 = (POT_XTRA<<0) + (SLIDE_L<<5) + (SLIDE_R<<10) + (BATTERY<<15); // conversions 7 and more
   ADC1->SQR3 = (STICK_LH<<0) + (STICK_LV<<5) + (STICK_RV<<10) + (STICK_RH<<15) + (POT_L<<20) + (POT_R<<25); // conversions 1 to 6
@@ -120,10 +204,10 @@ void adcInit()
 
   ADC->CCR = 0 ; //ADC_CCR_ADCPRE_0 ;             // Clock div 2
 
-  DMA2_Stream0->CR = DMA_SxCR_PL | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC;
+  DMA2_Stream0->CR = DMA_SxCR_PL | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
   DMA2_Stream0->PAR = CONVERT_PTR_UINT(&ADC1->DR);
-  DMA2_Stream0->M0AR = CONVERT_PTR_UINT(Analog_values);
-  DMA2_Stream0->NDTR = NUMBER_ANALOG_ADC1;
+  DMA2_Stream0->M0AR = CONVERT_PTR_UINT(adc1Samples);
+  DMA2_Stream0->NDTR = 2*ADC_OVERSAMPLING*NUMBER_ANALOG_ADC1;
   DMA2_Stream0->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 ;
 
 #if defined(REV9E)
@@ -131,7 +215,7 @@ void adcInit()
   configure_pins( PIN_FLP_J3 | PIN_FLP_J4 | PIN_FLP_J5, PIN_ANALOG | PIN_PORTF ) ;
 
   ADC3->CR1 = ADC_CR1_SCAN ;
-  ADC3->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS ;
+  ADC3->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_CONT ;
   ADC3->SQR1 = (NUMBER_ANALOG_ADC3-1) << 20 ;   // NUMBER_ANALOG Channels
   ADC3->SQR2 = 0; 
   ADC3->SQR3 = (SLIDER_L2<<0) + (SLIDER_R2<<5) + (POT_4<<10) ; // conversions 1 to 3
@@ -139,20 +223,25 @@ void adcInit()
   ADC3->SMPR2 = 0;
   
   // Enable the DMA channel here, DMA2 stream 1, channel 2
-  DMA2_Stream1->CR = DMA_SxCR_PL | DMA_SxCR_CHSEL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC;
+  DMA2_Stream1->CR = DMA_SxCR_PL | DMA_SxCR_CHSEL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC;
   DMA2_Stream1->PAR = CONVERT_PTR_UINT(&ADC3->DR);
-  DMA2_Stream1->M0AR = CONVERT_PTR_UINT(Analog_values + NUMBER_ANALOG_ADC1);
-  DMA2_Stream1->NDTR = NUMBER_ANALOG_ADC3;
+  DMA2_Stream1->M0AR = CONVERT_PTR_UINT(adc3Samples);
+  DMA2_Stream1->NDTR = 2*ADC_OVERSAMPLING*NUMBER_ANALOG_ADC3;
   DMA2_Stream1->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 ;
 #endif  // #if defined(REV9E)
+
+  adcStart();
 }
 
-void adcRead()
+void adcStart()
 {
+  adcSampled = false;
   DMA2_Stream0->CR &= ~DMA_SxCR_EN ;              // Disable DMA
   ADC1->SR &= ~(uint32_t) ( ADC_SR_EOC | ADC_SR_STRT | ADC_SR_OVR ) ;
   DMA2->LIFCR = DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 |DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0 ; // Write ones to clear bits
   DMA2_Stream0->CR |= DMA_SxCR_EN ;               // Enable DMA
+  NVIC_SetPriority(DMA2_Stream0_IRQn, 7);
+  NVIC_EnableIRQ(DMA2_Stream0_IRQn);
   ADC1->CR2 |= (uint32_t)ADC_CR2_SWSTART ;
 
 #if defined(REV9E)
@@ -162,40 +251,42 @@ void adcRead()
   DMA2_Stream1->CR |= DMA_SxCR_EN ;   // Enable DMA
   ADC3->CR2 |= (uint32_t)ADC_CR2_SWSTART ;
 #endif  // #if defined(REV9E)
+}
 
-#if defined(REV9E)
-  for (unsigned int i=0; i<10000; i++) {
-    if ((DMA2->LISR & DMA_LISR_TCIF0) && (DMA2->LISR & DMA_LISR_TCIF1)) {
-      break;
-    }
-  }
+void adcStop()
+{
+  NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+  ADC1->CR2 &= ~ADC_CR2_CONT;
   DMA2_Stream0->CR &= ~DMA_SxCR_EN ;              // Disable DMA
+#if defined(REV9E)
+  ADC3->CR2 &= ~ADC_CR2_CONT;
   DMA2_Stream1->CR &= ~DMA_SxCR_EN ;              // Disable DMA
-#else
-  for (unsigned int i=0; i<10000; i++) {
-    if (DMA2->LISR & DMA_LISR_TCIF0) {
-      break;
-    }
-  }
-  DMA2_Stream0->CR &= ~DMA_SxCR_EN ;              // Disable DMA
 #endif
+}
 
-  // adc direction correct
-  for (uint32_t i=0; i<NUMBER_ANALOG; i++) {
-    if (ana_direction[i] < 0) {
-      Analog_values[i] = 4096-Analog_values[i];
-    }
-#if !defined(REVPLUS)
-    else if (ana_direction[i] == 0) {
-      Analog_values[i] = 0;
-    }
+extern "C" void DMA2_Stream0_IRQHandler()
+{
+  uint32_t first = (DMA2->LISR & DMA_LISR_HTIF0) ? 0 : ADC_OVERSAMPLING;
+  DMA2->LIFCR = DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0 ; // Write ones to clear bits
+  adcFilterSamples(&adc1Samples[first][0], NUMBER_ANALOG_ADC1, 0);
+
+#if defined(REV9E)
+  // ADC3 has its own pace, use the half which is not being written
+  first = (DMA2_Stream1->NDTR > ADC_OVERSAMPLING*NUMBER_ANALOG_ADC3) ? ADC_OVERSAMPLING : 0;
+  adcFilterSamples(&adc3Samples[first][0], NUMBER_ANALOG_ADC3, NUMBER_ANALOG_ADC1);
 #endif
-  }
+
+  adcSampled = true;
 }
 
-// TODO
-void adcStop()
+// The startup checks must not see the zeros which precede the first DMA interrupt
+void adcWaitSampled()
 {
+#if !defined(SIMU)
+  for (int i=0; i<10 && !adcSampled; i++) {
+    CoTickDelay(1);  // 2ms
+  }
+#endif
 }
 
 uint16_t getAnalogValue(uint32_t value)
@@ -97,26 +97,14 @@ extern "C" void USART6_IRQHandler(void)
 
 int bt_write(const void *buffer, int len)
 {
-  uint8_t *data = (uint8_t *)buffer;
-  for (int i=0; i<len; ++i) {
-    btTxFifo.push(data[i]);
-  }
+  btTxFifo.write((const uint8_t *)buffer, len);
   USART_ITConfig(BT_UART, USART_IT_TXE, ENABLE);
   return 0;
 }
 
 int bt_read(void *buffer, int len)
 {
-  int result = 0;
-  uint8_t *data = (uint8_t *)buffer;
-  while (1) {
-    uint8_t byte;
-    if (!btRxFifo.pop(byte))
-      return result;
-    data[result++] = byte;
-    if (result >= len)
-      return result;
-  }
+  return btRxFifo.read((uint8_t *)buffer, len);
 }
 
 int bt_close()
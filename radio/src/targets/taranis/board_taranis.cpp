@@ -166,11 +166,14 @@ extern USB_OTG_CORE_HANDLE USB_OTG_dev;
 void usbJoystickUpdate(void)
 {
   static uint8_t HID_Buffer[HID_IN_PACKET];
-  
+  int16_t channels[16];
+
+  readChannelOutputsFrame(channels, 0, 16);
+
   //buttons
   HID_Buffer[0] = 0; //buttons
   for (int i = 0; i < 8; ++i) {
-    if ( channelOutputs[i+8] > 0 ) {
+    if ( channels[i+8] > 0 ) {
       HID_Buffer[0] |= (1 << i);
     } 
   }
@@ -178,7 +181,7 @@ void usbJoystickUpdate(void)
   //analog values
   //uint8_t * p = HID_Buffer + 1;
   for (int i = 0; i < 8; ++i) {
-    int16_t value = channelOutputs[i] / 8;
+    int16_t value = channels[i] / 8;
     if ( value > 127 ) value = 127;
     else if ( value < -127 ) value = -127;
     HID_Buffer[i+1] = static_cast<int8_t>(value);  
@@ -223,8 +223,32 @@ void watchdogInit(unsigned int duration);
 #endif
 
 // ADC driver
+enum AdcFilterModes {
+  ADC_FILTER_NONE,
+  ADC_FILTER_MOVING_AVERAGE,
+  ADC_FILTER_ONE_POLE,
+  ADC_FILTER_MEDIAN
+};
+
+#define ADC_FILTER_HISTORY        4
+#define ADC_FILTER_ONE_POLE_SHIFT 2
+
+struct AdcFilterState {
+  uint8_t  mode;
+  uint8_t  initialized;
+  uint8_t  index;
+  uint16_t history[ADC_FILTER_HISTORY];
+  uint32_t accumulator;
+};
+
 void adcInit(void);
-void adcRead(void);
+void adcStart(void);
+void adcStop(void);
+void adcWaitSampled(void);
+void adcSetFilter(uint8_t index, uint8_t mode);
+uint16_t adcFilter(AdcFilterState & state, uint16_t value);
+// Filtered values are the sum of ADC_OVERSAMPLING 12 bits samples
+#define ADC_OVERSAMPLING          8
 inline uint16_t getAnalogValue(uint32_t value);
 
 #define BATT_SCALE    150
@@ -282,6 +306,7 @@ void eeWriteBlockCmp(const void *pointer_ram, uint16_t pointer_eeprom, size_t si
 
 // Debug driver
 void debugPutc(const char c);
+void debugWrite(const char * data, uint32_t len);
 
 // Telemetry driver
 void telemetryPortInit(uint32_t baudrate);
@@ -301,6 +326,7 @@ void hapticOff(void);
 #define DEBUG_BAUDRATE      115200
 void uart3Init(unsigned int mode, unsigned int protocol);
 void uart3Putc(const char c);
+void uart3Write(const uint8_t * data, uint32_t len);
 #define telemetrySecondPortInit(protocol) uart3Init(UART_MODE_TELEMETRY, protocol)
 void uart3SbusInit(void);
 void uart3Stop(void);
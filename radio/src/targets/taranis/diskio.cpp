@@ -1009,9 +1009,6 @@ void sdPoll10ms()
 // TODO everything here should not be in the driver layer ...
 
 FATFS g_FATFS_Obj;
-#if defined(SPORT_FILE_LOG)
-FIL g_telemetryFile = {0};
-#endif
 
 #if defined(BOOT)
 void sdInit(void)
@@ -1035,13 +1032,6 @@ void sdInit(void)
     sdGetFreeSectors();
 
     referenceSystemAudioFiles();
-    
-#if defined(SPORT_FILE_LOG)
-    f_open(&g_telemetryFile, LOGS_PATH "/sport.log", FA_OPEN_ALWAYS | FA_WRITE);
-    if (f_size(&g_telemetryFile) > 0) {
-      f_lseek(&g_telemetryFile, f_size(&g_telemetryFile)); // append
-    }
-#endif
   }
 }
 
@@ -1049,8 +1039,8 @@ void sdDone()
 {
   if (sdMounted()) {
     audioQueue.stopSD();
-#if defined(SPORT_FILE_LOG)
-    f_close(&g_telemetryFile);
+#if defined(TELEMETRY_RECORD)
+    telemetryRecorderStop();
 #endif
     f_mount(NULL, "", 0); // unmount SD
   }
@@ -107,8 +107,15 @@ extern "C" void USART2_IRQHandler()
   while (status & (USART_FLAG_RXNE | USART_FLAG_ERRORS)) {
     data = SPORT->DR;
 
-    if (!(status & USART_FLAG_ERRORS))
+    if (!(status & USART_FLAG_ERRORS)) {
       telemetryFifo.push(data);
+      if (data == START_STOP) {
+        // a frame has ended, the telemetry task may parse it
+        CoEnterISR();
+        isr_SetFlag(telemetryFlag);
+        CoExitISR();
+      }
+    }
 
     status = SPORT->SR;
   }
@@ -38,7 +38,6 @@
 
 uint16_t * TrainerPulsePtr;
 extern uint16_t ppmStream[NUM_MODULES+1][20];
-extern Fifo<32> sbusFifo;
 
 #define setupTrainerPulses() setupPulsesPPM(TRAINER_MODULE)
 
@@ -243,8 +242,25 @@ void init_sbus_on_heartbeat_capture()
   USART_InitStructure.USART_Mode = USART_Mode_Rx;
 
   USART_Init(USART6, &USART_InitStructure);
-  USART_Cmd(USART6, ENABLE);
+
+#if !defined(REV9E)
+  // RX on DMA2 Stream1 Channel5, circular, frames detected with the idle line interrupt
+  RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+  DMA2_Stream1->CR &= ~DMA_SxCR_EN;
+  DMA2->LIFCR = DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1; // Write ones to clear bits
+  DMA2_Stream1->CR = DMA_SxCR_CHSEL_0 | DMA_SxCR_CHSEL_2 | DMA_SxCR_PL_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC;
+  DMA2_Stream1->PAR = CONVERT_PTR_UINT(&USART6->DR);
+  DMA2_Stream1->M0AR = CONVERT_PTR_UINT(sbusDmaRing.buffer);
+  DMA2_Stream1->NDTR = SBUS_DMA_BUFFER_SIZE;
+  sbusDmaRing.readIndex = 0;
+  DMA2_Stream1->CR |= DMA_SxCR_EN;
+  USART6->CR3 |= USART_CR3_DMAR;
+  USART_ITConfig(USART6, USART_IT_IDLE, ENABLE);
+#else
   USART_ITConfig(USART6, USART_IT_RXNE, ENABLE);
+#endif
+
+  USART_Cmd(USART6, ENABLE);
 
   NVIC_SetPriority(USART6_IRQn, 6);
   NVIC_EnableIRQ(USART6_IRQn);
@@ -254,6 +270,10 @@ void stop_sbus_on_heartbeat_capture(void)
 {
   configure_pins( 0x0080, PIN_INPUT | PIN_PORTC ) ;
   NVIC_DisableIRQ(USART6_IRQn) ;
+#if !defined(REV9E)
+  USART6->CR3 &= ~USART_CR3_DMAR;
+  DMA2_Stream1->CR &= ~DMA_SxCR_EN;
+#endif
 
   if (!IS_PULSES_EXTERNAL_MODULE()) {
     EXTERNAL_MODULE_OFF();
@@ -263,18 +283,11 @@ void stop_sbus_on_heartbeat_capture(void)
 #if !defined(SIMU) && !defined(REV9E)
 extern "C" void USART6_IRQHandler()
 {
-  uint32_t status;
-  uint8_t data;
-
-  status = USART6->SR;
-
-  while (status & (USART_FLAG_RXNE | USART_FLAG_ERRORS)) {
-    data = USART6->DR;
-
-    if (!(status & USART_FLAG_ERRORS))
-      sbusFifo.push(data);
+  uint32_t status = USART6->SR;
 
-    status = USART6->SR;
+  if (status & USART_FLAG_IDLE) {
+    (void)USART6->DR; // clears the idle and error flags
+    processSbusDmaRing(SBUS_DMA_BUFFER_SIZE - DMA2_Stream1->NDTR, status & USART_FLAG_ERRORS);
   }
 }
 #endif
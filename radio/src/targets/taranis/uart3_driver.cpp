@@ -39,7 +39,6 @@
 uint8_t uart3Mode = UART_MODE_NONE;
 Fifo<512> uart3TxFifo;
 extern Fifo<512> telemetryFifo;
-extern Fifo<32> sbusFifo;
 
 void uart3Setup(unsigned int baudrate)
 {
@@ -108,6 +107,13 @@ void uart3Putc(const char c)
   USART_ITConfig(UART3, USART_IT_TXE, ENABLE);
 }
 
+// the TXE interrupt still sends one byte at a time, only the producer side is bulk
+void uart3Write(const uint8_t * data, uint32_t len)
+{
+  uart3TxFifo.write(data, len);
+  USART_ITConfig(UART3, USART_IT_TXE, ENABLE);
+}
+
 #if defined(DEBUG)
 void debugPutc(const char c)
 {
@@ -115,16 +121,38 @@ void debugPutc(const char c)
     uart3Putc(c);
   }
 }
+
+void debugWrite(const char * data, uint32_t len)
+{
+  if (uart3Mode == UART_MODE_DEBUG) {
+    uart3Write((const uint8_t *)data, len);
+  }
+}
 #endif
 
 void uart3SbusInit()
 {
   uart3Setup(100000);
   USART3->CR1 |= USART_CR1_M | USART_CR1_PCE ;
+
+  // RX on DMA1 Stream1 Channel4, circular, frames detected with the idle line interrupt
+  RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+  DMA1_Stream1->CR &= ~DMA_SxCR_EN;
+  DMA1->LIFCR = DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1; // Write ones to clear bits
+  DMA1_Stream1->CR = DMA_SxCR_CHSEL_2 | DMA_SxCR_PL_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC;
+  DMA1_Stream1->PAR = CONVERT_PTR_UINT(&USART3->DR);
+  DMA1_Stream1->M0AR = CONVERT_PTR_UINT(sbusDmaRing.buffer);
+  DMA1_Stream1->NDTR = SBUS_DMA_BUFFER_SIZE;
+  sbusDmaRing.readIndex = 0;
+  DMA1_Stream1->CR |= DMA_SxCR_EN;
+  USART3->CR3 |= USART_CR3_DMAR;
+  USART_ITConfig(UART3, USART_IT_RXNE, DISABLE);
+  USART_ITConfig(UART3, USART_IT_IDLE, ENABLE);
 }
 
 void uart3Stop()
 {
+  DMA1_Stream1->CR &= ~DMA_SxCR_EN;
   USART_DeInit(USART3);
 }
 
@@ -145,17 +173,24 @@ extern "C" void USART3_IRQHandler(void)
 
   // Receive
   uint32_t status = USART3->SR;
+  if (uart3Mode == UART_MODE_SBUS_TRAINER) {
+    // SBUS bytes are received by the DMA
+    if (status & USART_FLAG_IDLE) {
+      (void)USART3->DR; // clears the idle and error flags
+      processSbusDmaRing(SBUS_DMA_BUFFER_SIZE - DMA1_Stream1->NDTR, status & USART_FLAG_ERRORS);
+    }
+    return;
+  }
+
   while (status & (USART_FLAG_RXNE | USART_FLAG_ERRORS)) {
     uint8_t data = USART3->DR;
 
-    if (!(status & USART_FLAG_ERRORS)) {
-      switch (uart3Mode) {
-        case UART_MODE_TELEMETRY:
-          telemetryFifo.push(data);
-          break;
-        case UART_MODE_SBUS_TRAINER:
-          sbusFifo.push(data);
-          break;
+    if (!(status & USART_FLAG_ERRORS) && uart3Mode == UART_MODE_TELEMETRY) {
+      telemetryFifo.push(data);
+      if (data == START_STOP) {
+        CoEnterISR();
+        isr_SetFlag(telemetryFlag);
+        CoExitISR();
       }
     }
 
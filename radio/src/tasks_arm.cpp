@@ -41,6 +41,7 @@
 #define AUDIO_STACK_SIZE    500
 #define BT_STACK_SIZE       500
 #define DEBUG_STACK_SIZE    500
+#define TELEMETRY_STACK_SIZE  500
 
 #if defined(_MSC_VER)
   #define _ALIGNED(x) __declspec(align(x))
@@ -58,6 +59,11 @@ OS_STK mixerStack[MIXER_STACK_SIZE];
 OS_TID audioTaskId;
 OS_STK audioStack[AUDIO_STACK_SIZE];
 
+#if defined(FRSKY) || defined(MAVLINK)
+OS_TID telemetryTaskId;
+OS_STK telemetryStack[TELEMETRY_STACK_SIZE];
+#endif
+
 #if defined(BLUETOOTH)
 OS_TID btTaskId;
 OS_STK btStack[BT_STACK_SIZE];
@@ -70,6 +76,8 @@ OS_STK debugStack[DEBUG_STACK_SIZE];
 
 OS_MutexID audioMutex;
 OS_MutexID mixerMutex;
+OS_MutexID telemetryMutex;
+OS_FlagID telemetryFlag;
 
 void stack_paint()
 {
@@ -79,6 +87,10 @@ void stack_paint()
     mixerStack[i] = 0x55555555;
   for (uint32_t i=0; i<AUDIO_STACK_SIZE; i++)
     audioStack[i] = 0x55555555;
+#if defined(FRSKY) || defined(MAVLINK)
+  for (uint32_t i=0; i<TELEMETRY_STACK_SIZE; i++)
+    telemetryStack[i] = 0x55555555;
+#endif
 }
 
 uint32_t stack_free(uint32_t tid)
@@ -99,6 +111,12 @@ uint32_t stack_free(uint32_t tid)
       stack = audioStack;
       size = AUDIO_STACK_SIZE;
       break;
+#if defined(FRSKY) || defined(MAVLINK)
+    case 3:
+      stack = telemetryStack;
+      size = TELEMETRY_STACK_SIZE;
+      break;
+#endif
 #if defined(PCBTARANIS)
     case 255:
   #if defined(SIMU)
@@ -137,7 +155,10 @@ void mixerTask(void * pdata)
       CoLeaveMutexSection(mixerMutex);
 
 #if defined(FRSKY) || defined(MAVLINK)
-      telemetryWakeup();
+      if (telemetryTaskId == E_CREATE_FAIL) {
+        // no telemetry task, the telemetry is parsed here as it used to be
+        telemetryWakeup();
+      }
 #endif
 
       if (heartbeat == HEART_WDT_CHECK) {
@@ -153,6 +174,25 @@ void mixerTask(void * pdata)
   }
 }
 
+#if defined(FRSKY) || defined(MAVLINK)
+#define TELEMETRY_TASK_PERIOD_TICKS 5     // 10ms
+
+void telemetryTask(void * pdata)
+{
+  while(1) {
+    // woken up by the telemetry receive interrupts at the end of each frame,
+    // or after one period for the sensors timeouts and the alarms
+    CoWaitForSingleFlag(telemetryFlag, TELEMETRY_TASK_PERIOD_TICKS);
+
+    if (!s_pulses_paused) {
+      CoEnterMutexSection(telemetryMutex);
+      telemetryWakeup();
+      CoLeaveMutexSection(telemetryMutex);
+    }
+  }
+}
+#endif
+
 #define MENU_TASK_PERIOD_TICKS      10    // 20ms
 
 extern void opentxClose();
@@ -207,10 +247,18 @@ void tasksStart()
   mixerTaskId = CoCreateTask(mixerTask, NULL, 5, &mixerStack[MIXER_STACK_SIZE-1], MIXER_STACK_SIZE);
   menusTaskId = CoCreateTask(menusTask, NULL, 10, &menusStack[MENUS_STACK_SIZE-1], MENUS_STACK_SIZE);
   audioTaskId = CoCreateTask(audioTask, NULL, 7, &audioStack[AUDIO_STACK_SIZE-1], AUDIO_STACK_SIZE);
+#if defined(FRSKY) || defined(MAVLINK)
+  telemetryTaskId = CoCreateTask(telemetryTask, NULL, 8, &telemetryStack[TELEMETRY_STACK_SIZE-1], TELEMETRY_STACK_SIZE);
+  if (telemetryTaskId == E_CREATE_FAIL) {
+    TRACE("telemetry task creation failed, telemetry parsed in the mixer task");
+  }
+#endif
 
 #if !defined(SIMU)
   audioMutex = CoCreateMutex();
   mixerMutex = CoCreateMutex();
+  telemetryMutex = CoCreateMutex();
+  telemetryFlag = CoCreateFlag(true, false); // auto-reset, initially not set
 #endif
 
   CoStartOS();
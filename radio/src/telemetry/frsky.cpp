@@ -69,6 +69,7 @@ FrskyData frskyData;
 
 #if defined(CPUARM)
 uint8_t telemetryProtocol = 255;
+volatile bool telemetryResetRequested = false;
 #define IS_FRSKY_D_PROTOCOL()      (telemetryProtocol == PROTOCOL_FRSKY_D)
 #define IS_FRSKY_SPORT_PROTOCOL()  (telemetryProtocol == PROTOCOL_FRSKY_SPORT)
 #else
@@ -266,36 +267,46 @@ NOINLINE void processSerialData(uint8_t data)
 #endif
 }
 
+#if defined(CPUARM)
+void telemetryRequestReset()
+{
+  telemetryResetRequested = true;
+#if !defined(SIMU)
+  CoSetFlag(telemetryFlag);
+#endif
+}
+#endif
+
 void telemetryWakeup()
 {
 #if defined(CPUARM)
+  if (telemetryResetRequested) {
+    telemetryResetRequested = false;
+    telemetryReset();
+  }
+
   uint8_t requiredTelemetryProtocol = MODEL_TELEMETRY_PROTOCOL();
   if (telemetryProtocol != requiredTelemetryProtocol) {
     telemetryProtocol = requiredTelemetryProtocol;
     telemetryInit();
+#if defined(TELEMETRY_RECORD)
+    telemetryRecorderStart(telemetryProtocol);
+#endif
   }
 #endif
 
 #if defined(PCBTARANIS)
-  uint8_t data;
-#if defined(SPORT_FILE_LOG) && !defined(SIMU)
-  static tmr10ms_t lastTime = 0;
-  tmr10ms_t newTime = get_tmr10ms();
-  struct gtm utm;
-  gettime(&utm);
-#endif
-  while (telemetryFifo.pop(data)) {
-    processSerialData(data);
-#if defined(SPORT_FILE_LOG) && !defined(SIMU)
-    extern FIL g_telemetryFile;
-    if (lastTime != newTime) {
-      f_printf(&g_telemetryFile, "\r\n%4d-%02d-%02d,%02d:%02d:%02d.%02d0: %02X", utm.tm_year+1900, utm.tm_mon+1, utm.tm_mday, utm.tm_hour, utm.tm_min, utm.tm_sec, g_ms100, data);
-      lastTime = newTime;
+  const uint8_t * region;
+  uint32_t count;
+  // the bytes are parsed in place, without copying them out of the fifo
+  while ((count = telemetryFifo.peek(region)) > 0) {
+#if defined(TELEMETRY_RECORD)
+    telemetryRecorderWrite(getTelemetryRecorderTime(), region, count);
+#endif
+    for (uint32_t i=0; i<count; i++) {
+      processSerialData(region[i]);
     }
-    else {
-      f_printf(&g_telemetryFile, " %02X", data);
-    }
-#endif
+    telemetryFifo.skip(count);
   }
 #elif defined(PCBSKY9X)
   if (telemetryProtocol == PROTOCOL_FRSKY_D_SECONDARY) {
@@ -324,12 +335,7 @@ void telemetryWakeup()
 #endif
 
 #if defined(CPUARM)
-  for (int i=0; i<TELEM_VALUES_MAX; i++) {
-    const TelemetrySensor & sensor = g_model.telemetrySensors[i];
-    if (sensor.type == TELEM_TYPE_CALCULATED) {
-      telemetryItems[i].eval(sensor);
-    }
-  }
+  telemetryEvalFormulas();
 #endif
 
 #if defined(VARIO)
@@ -357,6 +363,7 @@ void telemetryWakeup()
         uint8_t lastReceived = telemetryItems[i].lastReceived;
         if (lastReceived < TELEMETRY_VALUE_TIMER_CYCLE && uint8_t(now - lastReceived) > TELEMETRY_VALUE_OLD_THRESHOLD) {
           telemetryItems[i].lastReceived = TELEMETRY_VALUE_OLD;
+          telemetryItems[i].setChanged();
         }
       }
     }
@@ -391,6 +398,8 @@ void telemetryWakeup()
     telemetryState = TELEMETRY_KO;
     AUDIO_TELEMETRY_LOST();
   }
+
+  telemetryPublishSnapshot();
 #endif
 }
 
@@ -487,6 +496,8 @@ void telemetryReset()
   for (int index=0; index<TELEM_VALUES_MAX; index++) {
     telemetryItems[index].clear();
   }
+  // the sensors of another model may have been loaded
+  telemetryInvalidateFormulas();
 #endif
 
   frskyStreaming = 0; // reset counter only if valid frsky packets are being detected
@@ -471,6 +471,12 @@ enum FrSkyDataState {
   }
 #endif
 
+void processSerialData(uint8_t data);
+
+#if defined(CPUARM)
+extern uint8_t telemetryProtocol;
+#endif
+
 // FrSky D Protocol
 void processHubPacket(uint8_t id, int16_t value);
 void frskyDSendNextAlarm(void);
@@ -478,9 +484,39 @@ void frskyDProcessPacket(uint8_t *packet);
 
 // FrSky S.PORT Protocol
 void processSportPacket(uint8_t *packet);
+bool checkSportPacket(uint8_t *packet);
+
+#if defined(CPUARM)
+// The sensors tables are sorted by id, the lookups are binary searches
+struct FrSkySportSensor {
+  const uint16_t firstId;
+  const uint16_t lastId;
+  const char * name;
+  const TelemetryUnit unit;
+  const uint8_t prec;
+};
+
+struct FrSkyDSensor {
+  const uint8_t id;
+  const char * name;
+  const TelemetryUnit unit;
+  const uint8_t prec;
+};
+
+extern const FrSkySportSensor sportSensors[];
+extern const FrSkyDSensor frskyDSensors[];
+const FrSkySportSensor * getFrSkySportSensor(uint16_t id);
+const FrSkyDSensor * getFrSkyDSensor(uint8_t id);
+#endif
 
 void telemetryWakeup(void);
 void telemetryReset();
+#if defined(CPUARM)
+// the reset is performed by the telemetry task, which may be parsing a frame
+void telemetryRequestReset();
+#else
+#define telemetryRequestReset() telemetryReset()
+#endif
 void telemetryInit(void);
 void telemetryInterrupt10ms(void);
 
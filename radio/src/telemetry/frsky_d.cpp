@@ -500,47 +500,46 @@ bool isFrskyAlarmRaised(uint8_t idx)
 #endif
 
 #if defined(CPUARM)
-struct FrSkyDSensor {
-  const uint8_t id;
-  const char * name;
-  const TelemetryUnit unit;
-  const uint8_t prec;
-};
-
+// must stay sorted by id (checked in tests/frsky.cpp)
 const FrSkyDSensor frskyDSensors[] = {
-  { D_RSSI_ID, ZSTR_RSSI, UNIT_RAW, 0 },
-  { D_A1_ID, ZSTR_A1, UNIT_VOLTS, 0 },
-  { D_A2_ID, ZSTR_A2, UNIT_VOLTS, 0 },
+  { GPS_ALT_BP_ID, ZSTR_GPSALT, UNIT_METERS, 0 },
+  { TEMP1_ID, ZSTR_TEMP, UNIT_CELSIUS, 0 },
   { RPM_ID, ZSTR_RPM, UNIT_RAW, 0 },
   { FUEL_ID, ZSTR_FUEL, UNIT_PERCENT, 0 },
-  { TEMP1_ID, ZSTR_TEMP, UNIT_CELSIUS, 0 },
   { TEMP2_ID, ZSTR_TEMP, UNIT_CELSIUS, 0 },
-  { CURRENT_ID, ZSTR_CURR, UNIT_AMPS, 1 },
+  { VOLTS_ID, ZSTR_CELLS, UNIT_CELLS, 2 },
+  { GPS_SPEED_BP_ID, ZSTR_GSPD, UNIT_KTS, 0 },
+  { GPS_COURS_BP_ID, ZSTR_HDG, UNIT_DEGREE, 0 },
+  { GPS_HOUR_MIN_ID, ZSTR_GPSDATETIME, UNIT_DATETIME, 0 },
+  { GPS_LAT_AP_ID, ZSTR_GPS, UNIT_GPS, 0 },
+  { BARO_ALT_AP_ID, ZSTR_ALT, UNIT_METERS, 2 },
   { ACCEL_X_ID, ZSTR_ACCX, UNIT_G, 3 },
   { ACCEL_Y_ID, ZSTR_ACCY, UNIT_G, 3 },
   { ACCEL_Z_ID, ZSTR_ACCZ, UNIT_G, 3 },
+  { CURRENT_ID, ZSTR_CURR, UNIT_AMPS, 1 },
   { VARIO_ID, ZSTR_VSPD, UNIT_METERS_PER_SECOND, 2 },
   { VFAS_ID, ZSTR_VFAS, UNIT_VOLTS, 2 },
-  { BARO_ALT_AP_ID, ZSTR_ALT, UNIT_METERS, 2 },
-  { GPS_SPEED_BP_ID, ZSTR_GSPD, UNIT_KTS, 0 },
-  { GPS_COURS_BP_ID, ZSTR_HDG, UNIT_DEGREE, 0 },
-  { VOLTS_ID, ZSTR_CELLS, UNIT_CELLS, 2 },
-  { GPS_ALT_BP_ID, ZSTR_GPSALT, UNIT_METERS, 0 },
-  { GPS_HOUR_MIN_ID, ZSTR_GPSDATETIME, UNIT_DATETIME, 0 },
-  { GPS_LAT_AP_ID, ZSTR_GPS, UNIT_GPS, 0 },
+  { D_RSSI_ID, ZSTR_RSSI, UNIT_RAW, 0 },
+  { D_A1_ID, ZSTR_A1, UNIT_VOLTS, 0 },
+  { D_A2_ID, ZSTR_A2, UNIT_VOLTS, 0 },
   { 0, NULL, UNIT_RAW, 0 } // sentinel
 };
 
 const FrSkyDSensor * getFrSkyDSensor(uint8_t id)
 {
-  const FrSkyDSensor * result = NULL;
-  for (const FrSkyDSensor * sensor = frskyDSensors; sensor->id; sensor++) {
-    if (id == sensor->id) {
-      result = sensor;
-      break;
-    }
-  }
-  return result;
+  int first = 0;
+  int last = DIM(frskyDSensors) - 2; // without the sentinel
+  while (first <= last) {
+    int middle = (first + last) / 2;
+    const FrSkyDSensor * sensor = &frskyDSensors[middle];
+    if (id < sensor->id)
+      last = middle - 1;
+    else if (id > sensor->id)
+      first = middle + 1;
+    else
+      return sensor;
+  }
+  return NULL;
 }
 
 void processHubPacket(uint8_t id, int16_t value)
@@ -36,58 +36,57 @@
 
 #include "../opentx.h"
 
-struct FrSkySportSensor {
-  const uint16_t firstId;
-  const uint16_t lastId;
-  const char * name;
-  const TelemetryUnit unit;
-  const uint8_t prec;
-};
-
+// must stay sorted by id, without overlapping ranges (checked in tests/frsky.cpp)
 const FrSkySportSensor sportSensors[] = {
-  { RSSI_ID, RSSI_ID, ZSTR_RSSI, UNIT_RAW, 0 },
-  { ADC1_ID, ADC1_ID, ZSTR_A1, UNIT_VOLTS, 0 },
-  { ADC2_ID, ADC2_ID, ZSTR_A2, UNIT_VOLTS, 0 },
-  { BATT_ID, BATT_ID, ZSTR_BATT, UNIT_VOLTS, 0 },
+  { ALT_FIRST_ID, ALT_LAST_ID, ZSTR_ALT, UNIT_METERS, 2 },
+  { VARIO_FIRST_ID, VARIO_LAST_ID, ZSTR_VSPD, UNIT_METERS_PER_SECOND, 2 },
+  { CURR_FIRST_ID, CURR_LAST_ID, ZSTR_CURR, UNIT_AMPS, 1 },
+  { VFAS_FIRST_ID, VFAS_LAST_ID, ZSTR_VFAS, UNIT_VOLTS, 2 },
+  { CELLS_FIRST_ID, CELLS_LAST_ID, ZSTR_CELLS, UNIT_CELLS, 2 },
   { T1_FIRST_ID, T2_LAST_ID, ZSTR_TEMP, UNIT_CELSIUS, 0 },
   { RPM_FIRST_ID, RPM_LAST_ID, ZSTR_RPM, UNIT_RPMS, 0 },
   { FUEL_FIRST_ID, FUEL_LAST_ID, ZSTR_FUEL, UNIT_PERCENT, 0 },
-  { ALT_FIRST_ID, ALT_LAST_ID, ZSTR_ALT, UNIT_METERS, 2 },
-  { VARIO_FIRST_ID, VARIO_LAST_ID, ZSTR_VSPD, UNIT_METERS_PER_SECOND, 2 },
   { ACCX_FIRST_ID, ACCX_LAST_ID, ZSTR_ACCX, UNIT_G, 2 },
   { ACCY_FIRST_ID, ACCY_LAST_ID, ZSTR_ACCY, UNIT_G, 2 },
   { ACCZ_FIRST_ID, ACCZ_LAST_ID, ZSTR_ACCZ, UNIT_G, 2 },
-  { CURR_FIRST_ID, CURR_LAST_ID, ZSTR_CURR, UNIT_AMPS, 1 },
-  { VFAS_FIRST_ID, VFAS_LAST_ID, ZSTR_VFAS, UNIT_VOLTS, 2 },
-  { AIR_SPEED_FIRST_ID, AIR_SPEED_LAST_ID, ZSTR_ASPD, UNIT_METERS_PER_SECOND, 1 },
-  { GPS_SPEED_FIRST_ID, GPS_SPEED_LAST_ID, ZSTR_GSPD, UNIT_KTS, 3 },
-  { CELLS_FIRST_ID, CELLS_LAST_ID, ZSTR_CELLS, UNIT_CELLS, 2 },
+  { GPS_LONG_LATI_FIRST_ID, GPS_LONG_LATI_LAST_ID, ZSTR_GPS, UNIT_GPS, 0 },
   { GPS_ALT_FIRST_ID, GPS_ALT_LAST_ID, ZSTR_GPSALT, UNIT_METERS, 2 },
+  { GPS_SPEED_FIRST_ID, GPS_SPEED_LAST_ID, ZSTR_GSPD, UNIT_KTS, 3 },
   { GPS_TIME_DATE_FIRST_ID, GPS_TIME_DATE_LAST_ID, ZSTR_GPSDATETIME, UNIT_DATETIME, 0 },
-  { GPS_LONG_LATI_FIRST_ID, GPS_LONG_LATI_LAST_ID, ZSTR_GPS, UNIT_GPS, 0 },
+  { AIR_SPEED_FIRST_ID, AIR_SPEED_LAST_ID, ZSTR_ASPD, UNIT_METERS_PER_SECOND, 1 },
+  { RSSI_ID, RSSI_ID, ZSTR_RSSI, UNIT_RAW, 0 },
+  { ADC1_ID, ADC1_ID, ZSTR_A1, UNIT_VOLTS, 0 },
+  { ADC2_ID, ADC2_ID, ZSTR_A2, UNIT_VOLTS, 0 },
+  { BATT_ID, BATT_ID, ZSTR_BATT, UNIT_VOLTS, 0 },
   { 0, 0, NULL, UNIT_RAW, 0 } // sentinel
 };
 
 const FrSkySportSensor * getFrSkySportSensor(uint16_t id)
 {
-  const FrSkySportSensor * result = NULL;
-  for (const FrSkySportSensor * sensor = sportSensors; sensor->firstId; sensor++) {
-    if (id >= sensor->firstId && id <= sensor->lastId) {
-      result = sensor;
-      break;
-    }
+  int first = 0;
+  int last = DIM(sportSensors) - 2; // without the sentinel
+  while (first <= last) {
+    int middle = (first + last) / 2;
+    const FrSkySportSensor * sensor = &sportSensors[middle];
+    if (id < sensor->firstId)
+      last = middle - 1;
+    else if (id > sensor->lastId)
+      first = middle + 1;
+    else
+      return sensor;
   }
-  return result;
+  return NULL;
 }
 
 bool checkSportPacket(uint8_t *packet)
 {
-  short crc = 0;
+  // the end-around carries are folded once after the whole sum
+  uint32_t crc = 0;
   for (int i=1; i<FRSKY_SPORT_PACKET_SIZE; ++i) {
-    crc += packet[i]; // 0-1FE
-    crc += crc >> 8;  // 0-1FF
-    crc &= 0x00ff;    // 0-FF
+    crc += packet[i];
   }
+  crc = (crc & 0xff) + (crc >> 8); // 0-1FF
+  crc = (crc & 0xff) + (crc >> 8); // 0-FF
   // TRACE("crc: 0x%02x", crc);
   return (crc == 0x00ff);
 }
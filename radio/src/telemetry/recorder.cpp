@@ -0,0 +1,252 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "../opentx.h"
+
+FIL telemetryRecorderFile = {0};
+uint8_t telemetryRecorderBuffer[TELEMETRY_RECORD_BUFFER_SIZE];
+uint16_t telemetryRecorderCount = 0;
+uint32_t telemetryRecorderLastTime = 0;
+bool telemetryRecorderRunning = false;
+
+// The 2MHz timer wraps every 32ms, the 10ms timer takes over for longer delays
+uint32_t getTelemetryRecorderTime()
+{
+  static uint32_t time = 0;
+  static uint16_t lastTmr2MHz = 0;
+  static tmr10ms_t lastTmr10ms = 0;
+
+  uint16_t tmr2MHz = getTmr2MHz();
+  tmr10ms_t tmr10ms = get_tmr10ms();
+  tmr10ms_t elapsed = tmr10ms - lastTmr10ms;
+
+  if (elapsed >= 3)
+    time += elapsed * TELEMETRY_RECORD_TICKS_PER_10MS;
+  else
+    time += (uint16_t)(tmr2MHz - lastTmr2MHz);
+
+  lastTmr2MHz = tmr2MHz;
+  lastTmr10ms = tmr10ms;
+  return time;
+}
+
+void telemetryRecorderFlush()
+{
+  UINT written;
+  if (telemetryRecorderCount > 0) {
+    if (f_write(&telemetryRecorderFile, telemetryRecorderBuffer, telemetryRecorderCount, &written) != FR_OK) {
+      telemetryRecorderStop();
+    }
+    telemetryRecorderCount = 0;
+  }
+}
+
+void telemetryRecorderPut(uint16_t delta, const uint8_t * data, uint8_t count)
+{
+  if (telemetryRecorderCount + 3 + count > TELEMETRY_RECORD_BUFFER_SIZE) {
+    telemetryRecorderFlush();
+    if (!telemetryRecorderRunning)
+      return;
+  }
+
+  uint8_t * ptr = &telemetryRecorderBuffer[telemetryRecorderCount];
+  *ptr++ = delta;
+  *ptr++ = delta >> 8;
+  *ptr++ = count;
+  memcpy(ptr, data, count);
+  telemetryRecorderCount += 3 + count;
+}
+
+bool telemetryRecorderStart(const char * filename, uint8_t protocol)
+{
+  UINT written;
+  uint8_t header[TELEMETRY_RECORD_HEADER_SIZE] = { 'O', 'T', 'X', 'T', 'L', 'M', TELEMETRY_RECORD_VERSION, protocol };
+
+  telemetryRecorderStop();
+
+  if (f_open(&telemetryRecorderFile, filename, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK)
+    return false;
+
+  if (f_write(&telemetryRecorderFile, header, sizeof(header), &written) != FR_OK) {
+    f_close(&telemetryRecorderFile);
+    return false;
+  }
+
+  telemetryRecorderCount = 0;
+  telemetryRecorderLastTime = getTelemetryRecorderTime();
+  telemetryRecorderRunning = true;
+  return true;
+}
+
+// starts a new /LOGS/telemetry-<date>.tlm record
+bool telemetryRecorderStart(uint8_t protocol)
+{
+  char filename[] = LOGS_PATH "/telemetry-YYYY-MM-DD-HHMMSS" TELEMETRY_RECORD_EXT;
+
+  if (!sdMounted())
+    return false;
+
+  char * tmp = &filename[sizeof(LOGS_PATH "/telemetry")-1];
+#if defined(RTCLOCK)
+  tmp = strAppendDate(tmp, true);
+#endif
+  strcpy(tmp, TELEMETRY_RECORD_EXT);
+
+  return telemetryRecorderStart(filename, protocol);
+}
+
+void telemetryRecorderStop()
+{
+  if (telemetryRecorderRunning) {
+    telemetryRecorderFlush();
+    telemetryRecorderRunning = false;
+    f_close(&telemetryRecorderFile);
+  }
+}
+
+bool isTelemetryRecorderRunning()
+{
+  return telemetryRecorderRunning;
+}
+
+void telemetryRecorderWrite(uint32_t time, const uint8_t * data, uint32_t count)
+{
+  if (!telemetryRecorderRunning)
+    return;
+
+  uint32_t delta = time - telemetryRecorderLastTime;
+  telemetryRecorderLastTime = time;
+
+  if (delta > 0xFFFF) {
+    telemetryRecorderPut(delta >> 16, NULL, 0);
+    delta &= 0xFFFF;
+  }
+
+  while (count > 0) {
+    uint8_t len = min<uint32_t>(count, 255);
+    telemetryRecorderPut(delta, data, len);
+    delta = 0;
+    data += len;
+    count -= len;
+  }
+}
+
+#if defined(SIMU)
+TelemetryReplay telemetryReplay;
+
+bool TelemetryReplay::open(const char * filename)
+{
+  uint8_t header[TELEMETRY_RECORD_HEADER_SIZE];
+  UINT read;
+
+  close();
+
+  if (f_open(&file, filename, FA_OPEN_EXISTING | FA_READ) != FR_OK)
+    return false;
+
+  if (f_read(&file, header, sizeof(header), &read) != FR_OK || read != sizeof(header) || memcmp(header, TELEMETRY_RECORD_MAGIC, sizeof(TELEMETRY_RECORD_MAGIC)-1) || header[6] != TELEMETRY_RECORD_VERSION) {
+    f_close(&file);
+    return false;
+  }
+
+  // the recorded frames are parsed with the protocol they were received with
+  telemetryProtocol = header[7];
+  opened = true;
+  recordTime = 0;
+  startTime = get_tmr10ms();
+  pending = readRecord();
+  return true;
+}
+
+void TelemetryReplay::close()
+{
+  if (opened) {
+    f_close(&file);
+    opened = false;
+    pending = false;
+  }
+}
+
+// reads the next record header, skipping the silences
+bool TelemetryReplay::readRecord()
+{
+  uint8_t header[3];
+  UINT read;
+
+  while (f_read(&file, header, sizeof(header), &read) == FR_OK && read == sizeof(header)) {
+    uint16_t delta = header[0] + (header[1] << 8);
+    if (header[2] == 0) {
+      recordTime += (uint32_t)delta << 16;
+    }
+    else {
+      recordTime += delta;
+      recordSize = header[2];
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// feeds the bytes recorded up to time (2MHz ticks from the start)
+uint32_t TelemetryReplay::feed(uint32_t time)
+{
+  uint8_t data[255];
+  uint32_t result = 0;
+  UINT read;
+
+  while (pending && recordTime <= time) {
+    if (f_read(&file, data, recordSize, &read) != FR_OK || read != recordSize) {
+      pending = false;
+      break;
+    }
+    for (unsigned int i=0; i<read; i++) {
+      processSerialData(data[i]);
+    }
+    result += read;
+    pending = readRecord();
+  }
+
+  return result;
+}
+
+void TelemetryReplay::wakeup()
+{
+  if (opened) {
+    feed((get_tmr10ms() - startTime) * speed * TELEMETRY_RECORD_TICKS_PER_10MS);
+  }
+}
+#endif
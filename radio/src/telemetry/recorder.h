@@ -0,0 +1,102 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef _RECORDER_H_
+#define _RECORDER_H_
+
+// A telemetry record file is an 8 bytes header (magic, version, protocol)
+// followed by one record per chunk of received bytes: the time since the
+// previous record in 2MHz ticks (16 bits, little endian), the bytes count,
+// then the bytes. A record without bytes carries a long silence, its time
+// is then counted in 65536 ticks units.
+#define TELEMETRY_RECORD_MAGIC          "OTXTLM"
+#define TELEMETRY_RECORD_VERSION        1
+#define TELEMETRY_RECORD_HEADER_SIZE    8
+#define TELEMETRY_RECORD_BUFFER_SIZE    512
+#define TELEMETRY_RECORD_EXT            ".tlm"
+#define TELEMETRY_RECORD_TICKS_PER_10MS 20000
+
+uint32_t getTelemetryRecorderTime();
+bool telemetryRecorderStart(const char * filename, uint8_t protocol);
+bool telemetryRecorderStart(uint8_t protocol);
+void telemetryRecorderStop();
+void telemetryRecorderWrite(uint32_t time, const uint8_t * data, uint32_t count);
+bool isTelemetryRecorderRunning();
+
+#if defined(SIMU)
+// Feeds processSerialData() with a record file, the simulator replays it at
+// the original speed (or faster), the tests as fast as possible
+class TelemetryReplay
+{
+  public:
+    TelemetryReplay():
+      speed(1),
+      opened(false)
+    {
+    }
+
+    bool open(const char * filename);
+    void close();
+    uint32_t feed(uint32_t time);
+    void wakeup();
+
+    bool isOpen()
+    {
+      return opened;
+    }
+
+    bool isFinished()
+    {
+      return !pending;
+    }
+
+    uint8_t speed;
+
+  protected:
+    bool readRecord();
+
+    FIL file;
+    bool opened;
+    bool pending;
+    uint32_t recordTime;
+    uint8_t recordSize;
+    tmr10ms_t startTime;
+};
+
+extern TelemetryReplay telemetryReplay;
+#endif
+
+#endif
@@ -2,6 +2,173 @@
 
 TelemetryItem telemetryItems[TELEM_VALUES_MAX];
 
+TelemetrySnapshot telemetrySnapshots[2];
+volatile uint32_t telemetrySnapshotSequence = 0;
+
+void telemetryPublishSnapshot()
+{
+  TelemetrySnapshot & snapshot = telemetrySnapshots[(telemetrySnapshotSequence+1) & 1];
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    snapshot.items[i].value = telemetryItems[i].value;
+    snapshot.items[i].valueMin = telemetryItems[i].valueMin;
+    snapshot.items[i].valueMax = telemetryItems[i].valueMax;
+  }
+  __sync_synchronize();
+  telemetrySnapshotSequence++;
+}
+
+uint8_t telemetryFormulasOrder[TELEM_VALUES_MAX];
+uint8_t telemetryFormulasCount = 0;
+bool telemetryFormulasDirty = true;
+uint32_t telemetryItemsChanged[(TELEM_VALUES_MAX+31)/32];
+
+void TelemetryItem::setChanged()
+{
+  int index = this - telemetryItems;
+  if (index >= 0 && index < TELEM_VALUES_MAX) {
+    telemetryItemsChanged[index/32] |= (1u << (index%32));
+  }
+}
+
+inline bool isTelemetryItemChanged(int index)
+{
+  return telemetryItemsChanged[index/32] & (1u << (index%32));
+}
+
+// returns the sensors used by a formula evaluated in TelemetryItem::eval()
+int getTelemetryFormulaSources(const TelemetrySensor & sensor, uint8_t * sources)
+{
+  int count = 0;
+
+  if (sensor.type != TELEM_TYPE_CALCULATED)
+    return -1;
+
+  switch (sensor.formula) {
+    case TELEM_FORMULA_CELL:
+      if (sensor.cell.source)
+        sources[count++] = sensor.cell.source-1;
+      break;
+
+    case TELEM_FORMULA_DIST:
+      if (sensor.dist.gps)
+        sources[count++] = sensor.dist.gps-1;
+      if (sensor.dist.alt)
+        sources[count++] = sensor.dist.alt-1;
+      break;
+
+    case TELEM_FORMULA_ADD:
+    case TELEM_FORMULA_AVERAGE:
+    case TELEM_FORMULA_MIN:
+    case TELEM_FORMULA_MAX:
+    case TELEM_FORMULA_MULTIPLY:
+    {
+      int maxitems = (sensor.formula == TELEM_FORMULA_MULTIPLY ? 2 : 4);
+      for (int i=0; i<maxitems; i++) {
+        if (sensor.calc.sources[i])
+          sources[count++] = abs(sensor.calc.sources[i])-1;
+      }
+      break;
+    }
+
+    default:
+      // the consumption is computed in TelemetryItem::per10ms()
+      return -1;
+  }
+
+  return count;
+}
+
+void telemetryInvalidateFormulas()
+{
+  telemetryFormulasDirty = true;
+}
+
+bool isTelemetryFormulaChanged(const TelemetrySensor & previous, const TelemetrySensor & sensor)
+{
+  uint8_t previousSources[4], sources[4];
+
+  if (previous.type != sensor.type || previous.formula != sensor.formula)
+    return true;
+
+  int count = getTelemetryFormulaSources(previous, previousSources);
+  if (count != getTelemetryFormulaSources(sensor, sources))
+    return true;
+
+  for (int i=0; i<count; i++) {
+    if (previousSources[i] != sources[i])
+      return true;
+  }
+
+  return false;
+}
+
+void telemetryBuildFormulas()
+{
+  bool placed[TELEM_VALUES_MAX];
+  uint8_t sources[4];
+
+  telemetryFormulasCount = 0;
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    placed[i] = (getTelemetryFormulaSources(g_model.telemetrySensors[i], sources) < 0);
+  }
+
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (int i=0; i<TELEM_VALUES_MAX; i++) {
+      if (!placed[i]) {
+        bool ready = true;
+        int count = getTelemetryFormulaSources(g_model.telemetrySensors[i], sources);
+        for (int j=0; j<count; j++) {
+          if (!placed[sources[j]])
+            ready = false;
+        }
+        if (ready) {
+          telemetryFormulasOrder[telemetryFormulasCount++] = i;
+          placed[i] = true;
+          progress = true;
+        }
+      }
+    }
+  }
+
+  // the formulas in a dependency loop are evaluated in the sensors order
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    if (!placed[i]) {
+      telemetryFormulasOrder[telemetryFormulasCount++] = i;
+    }
+  }
+
+  telemetryFormulasDirty = false;
+}
+
+void telemetryEvalFormulas()
+{
+  uint8_t sources[4];
+  bool all = false;
+
+  if (telemetryFormulasDirty) {
+    // all formulas are evaluated once with the new graph
+    telemetryBuildFormulas();
+    all = true;
+  }
+
+  for (int k=0; k<telemetryFormulasCount; k++) {
+    int index = telemetryFormulasOrder[k];
+    const TelemetrySensor & sensor = g_model.telemetrySensors[index];
+    bool changed = all;
+    int count = getTelemetryFormulaSources(sensor, sources);
+    for (int j=0; !changed && j<count; j++) {
+      changed = isTelemetryItemChanged(sources[j]);
+    }
+    if (changed) {
+      telemetryItems[index].eval(sensor);
+    }
+  }
+
+  memclear(telemetryItemsChanged, sizeof(telemetryItemsChanged));
+}
+
 void TelemetryItem::gpsReceived()
 {
   if (!distFromEarthAxis) {
@@ -12,11 +179,14 @@ void TelemetryItem::gpsReceived()
     distFromEarthAxis = 139*(((uint32_t)10000000-((angle2*(uint32_t)123370)/81)+(angle4/25))/12500);
   }
   lastReceived = now();
+  setChanged();
 }
 
 void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t newVal, uint32_t unit, uint32_t prec)
 {
   if (unit == UNIT_CELLS) {
+    // the cells formulas use the cells values even before the sum is known
+    setChanged();
     uint32_t data = uint32_t(newVal);
     uint8_t cellIndex = data & 0xF;
     uint8_t count = (data & 0xF0) >> 4;
@@ -187,6 +357,7 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t newVal, uin
 
   value = newVal;
   lastReceived = now();
+  setChanged();
 }
 
 bool TelemetryItem::isAvailable()
@@ -439,6 +610,7 @@ void delTelemetryIndex(uint8_t index)
 {
   memclear(&g_model.telemetrySensors[index], sizeof(TelemetrySensor));
   telemetryItems[index].clear();
+  telemetryInvalidateFormulas();
   eeDirty(EE_MODEL);
 }
 
@@ -156,6 +156,7 @@ class TelemetryItem
     void per10ms(const TelemetrySensor & sensor);
 
     void setValue(const TelemetrySensor & sensor, int32_t newVal, uint32_t unit, uint32_t prec=0);
+    void setChanged();
     bool isAvailable();
     bool isFresh();
     bool isOld();
@@ -164,6 +165,46 @@ class TelemetryItem
 
 extern TelemetryItem telemetryItems[TELEM_VALUES_MAX];
 
+// The sensors values as seen by the mixer and the menus. The telemetry task
+// writes the spare snapshot then flips the sequence.
+struct TelemetrySnapshotValue
+{
+  int32_t value;
+  int32_t valueMin;
+  int32_t valueMax;
+};
+
+struct TelemetrySnapshot
+{
+  TelemetrySnapshotValue items[TELEM_VALUES_MAX];
+};
+
+extern TelemetrySnapshot telemetrySnapshots[2];
+extern volatile uint32_t telemetrySnapshotSequence;
+
+// The spare snapshot is only rewritten after a flip, a reader which may be
+// preempted by the telemetry task (the menus) retries when the sequence moved
+inline TelemetrySnapshotValue getTelemetrySnapshotValue(int index)
+{
+  TelemetrySnapshotValue result;
+  uint32_t sequence;
+  do {
+    sequence = telemetrySnapshotSequence;
+    __sync_synchronize();
+    result = telemetrySnapshots[sequence & 1].items[index];
+    __sync_synchronize();
+  } while (sequence != telemetrySnapshotSequence);
+  return result;
+}
+
+void telemetryPublishSnapshot();
+
+// Calculated sensors are evaluated only when one of their sources changed,
+// each one after the sensors it depends on
+void telemetryInvalidateFormulas();
+bool isTelemetryFormulaChanged(const TelemetrySensor & previous, const TelemetrySensor & sensor);
+void telemetryEvalFormulas();
+
 inline bool isTelemetryFieldAvailable(int index)
 {
   TelemetrySensor & sensor = g_model.telemetrySensors[index];
@@ -0,0 +1,91 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "gtests.h"
+
+#if defined(PCBTARANIS)
+TEST(AdcFilter, None)
+{
+  AdcFilterState state;
+  memclear(&state, sizeof(state));
+  state.mode = ADC_FILTER_NONE;
+  EXPECT_EQ(adcFilter(state, 1000), 1000);
+  EXPECT_EQ(adcFilter(state, 3000), 3000);
+}
+
+TEST(AdcFilter, MovingAverage)
+{
+  AdcFilterState state;
+  memclear(&state, sizeof(state));
+  state.mode = ADC_FILTER_MOVING_AVERAGE;
+  EXPECT_EQ(adcFilter(state, 1000), 1000);
+  EXPECT_EQ(adcFilter(state, 2000), 1250);
+  EXPECT_EQ(adcFilter(state, 2000), 1500);
+  EXPECT_EQ(adcFilter(state, 2000), 1750);
+  EXPECT_EQ(adcFilter(state, 2000), 2000);
+}
+
+TEST(AdcFilter, OnePole)
+{
+  AdcFilterState state;
+  memclear(&state, sizeof(state));
+  state.mode = ADC_FILTER_ONE_POLE;
+  EXPECT_EQ(adcFilter(state, 1000), 1000);
+  EXPECT_EQ(adcFilter(state, 2000), 1250);
+  uint16_t value = 0;
+  for (int i=0; i<100; i++) {
+    value = adcFilter(state, 2000);
+  }
+  EXPECT_EQ(value, 2000);
+  for (int i=0; i<100; i++) {
+    value = adcFilter(state, 500);
+  }
+  EXPECT_EQ(value, 500);
+}
+
+TEST(AdcFilter, Median)
+{
+  AdcFilterState state;
+  memclear(&state, sizeof(state));
+  state.mode = ADC_FILTER_MEDIAN;
+  EXPECT_EQ(adcFilter(state, 1000), 1000);
+  // a single spike is removed
+  EXPECT_EQ(adcFilter(state, 4000), 1000);
+  EXPECT_EQ(adcFilter(state, 1010), 1010);
+  EXPECT_EQ(adcFilter(state, 1020), 1020);
+  EXPECT_EQ(adcFilter(state, 0), 1010);
+}
+#endif
@@ -162,3 +162,306 @@ TEST(EEPROM, rm)
   EXPECT_EQ(sz, 0);
 }
 #endif
+
+#if defined(PCBSKY9X)
+extern uint8_t eeprom[];
+void fill_file_index();
+
+TEST(EEPROM, journaledModelSave)
+{
+  eepromFile = NULL; // in memory
+
+  MODEL_RESET();
+  g_eeGeneral.currModel = 0;
+  fill_file_index();
+  ((uint8_t *)&g_model)[sizeof(g_model)-1] = 0xAA; // nothing trimmed, little room left for the journal
+  eeDirty(EE_MODEL);
+  eeCheck(true);
+  uint32_t sequence = File_system[1].sequence_no;
+
+  // a small change goes to the journal, the image stays in place
+  g_model.limitData[0].offset = 100;
+  eeDirty(EE_MODEL);
+  eeCheck(true);
+  EXPECT_EQ(File_system[1].sequence_no, sequence);
+
+  fill_file_index();
+  loadModel(0);
+  EXPECT_EQ(g_model.limitData[0].offset, 100);
+  EXPECT_EQ(((uint8_t *)&g_model)[sizeof(g_model)-1], 0xAA);
+
+  // a record cut by a power loss is dropped and the next save writes a full image
+  g_model.limitData[0].offset = 200;
+  eeDirty(EE_MODEL);
+  eeCheck(true);
+  eeprom[(File_system[1].block_no << 12) + File_system[1].journal - 1] ^= 0xFF;
+  fill_file_index();
+  loadModel(0);
+  EXPECT_EQ(g_model.limitData[0].offset, 100);
+  g_model.limitData[0].offset = 300;
+  eeDirty(EE_MODEL);
+  eeCheck(true);
+  EXPECT_EQ(File_system[1].sequence_no, sequence+1);
+
+  // the journal is compacted into a new image when the block is full
+  for (int i=0; i<20; i++) {
+    g_model.limitData[0].offset = i;
+    eeDirty(EE_MODEL);
+    eeCheck(true);
+  }
+  EXPECT_GT(File_system[1].sequence_no, sequence+1);
+  fill_file_index();
+  loadModel(0);
+  EXPECT_EQ(g_model.limitData[0].offset, 19);
+}
+
+TEST(EEPROM, journalOfUnflaggedBlockIgnored)
+{
+  eepromFile = NULL; // in memory
+
+  MODEL_RESET();
+  g_eeGeneral.currModel = 0;
+  fill_file_index();
+  g_model.header.name[0] = 'A'; // header changes are always written in a full image
+  eeDirty(EE_MODEL);
+  eeCheck(true);
+  uint32_t sequence = File_system[1].sequence_no;
+  g_model.limitData[0].offset = 100;
+  eeDirty(EE_MODEL);
+  eeCheck(true);
+  EXPECT_EQ(File_system[1].sequence_no, sequence);
+
+  // the same block, as an image written without journal support would be flagged
+  t_eeprom_header * header = (t_eeprom_header *)&eeprom[File_system[1].block_no << 12];
+  EXPECT_TRUE(header->flags & EE32_FLAG_JOURNAL);
+  header->flags = 0;
+  header->hcsum = 0;
+  for (int i=0; i<7; i++) {
+    header->hcsum += ((uint8_t *)header)[i];
+  }
+  fill_file_index();
+  loadModel(0);
+  EXPECT_EQ(g_model.limitData[0].offset, 0);
+
+  // the next save is a full image, which is flagged again
+  g_model.limitData[0].offset = 200;
+  eeDirty(EE_MODEL);
+  eeCheck(true);
+  EXPECT_EQ(File_system[1].sequence_no, sequence+1);
+  header = (t_eeprom_header *)&eeprom[File_system[1].block_no << 12];
+  EXPECT_TRUE(header->flags & EE32_FLAG_JOURNAL);
+}
+#endif
+
+#if defined(PCBTARANIS)
+extern uint8_t eeprom[];
+extern uint32_t eeprom_pages_written;
+extern blkid_t freeBlocks;
+
+#define EEPROM_USED (BLOCKS_OFFSET + BLOCKS*BS)
+
+static blkid_t eepromLink(blkid_t blk)
+{
+  blkid_t link;
+  memcpy(&link, &eeprom[blk*BS+BLOCKS_OFFSET], sizeof(link));
+  return link;
+}
+
+// counts the blocks of a chain, false if one of them is already used
+static bool markChain(blkid_t blk, uint8_t * used, int & count)
+{
+  count = 0;
+  while (blk) {
+    if (blk < FIRSTBLK || blk >= BLOCKS || used[blk])
+      return false;
+    used[blk] = 1;
+    count++;
+    blk = eepromLink(blk);
+  }
+  return true;
+}
+
+/*
+  Saves data in a model file, interrupted after each step of the writer as
+  a power loss would do, and checks the file system left on the EEPROM
+*/
+static void checkInterruptedWrites(uint8_t id, ModelData * data)
+{
+  uint8_t * image = new uint8_t[EEPROM_USED];
+  ModelData * previous = new ModelData;
+  memcpy(image, eeprom, EEPROM_USED);
+  EeFs fs = eeFs;
+  blkid_t initialFreeBlocks = freeBlocks;
+  loadModel(id);
+  memcpy(previous, &g_model, sizeof(g_model));
+
+  theFile.writeRlc(FILE_MODEL(id), FILE_TYP_MODEL, (uint8_t *)data, sizeof(ModelData), true);
+  blkid_t finalFreeBlocks = freeBlocks;
+
+  for (int steps=0; ; steps++) {
+    memcpy(eeprom, image, EEPROM_USED);
+    eeFs = fs;
+    freeBlocks = initialFreeBlocks;
+    theFile.writeRlc(FILE_MODEL(id), FILE_TYP_MODEL, (uint8_t *)data, sizeof(ModelData), false);
+    for (int i=0; i<steps && theFile.isWriting(); i++) {
+      theFile.nextRlcWriteStep();
+    }
+    bool complete = !theFile.isWriting();
+    blkid_t writerFreeBlocks = freeBlocks;
+
+    // restart
+    memcpy(&eeFs, eeprom, sizeof(eeFs));
+
+    // the free list is never cut nor shared with a file
+    uint8_t used[BLOCKS];
+    int count;
+    memset(used, 0, sizeof(used));
+    ASSERT_TRUE(markChain(eeFs.freeList, used, count)) << "step " << steps;
+    EXPECT_GE(count, min(initialFreeBlocks, finalFreeBlocks)) << "step " << steps;
+    for (int i=0; i<MAXFILES; i++) {
+      int blocks;
+      uint8_t fileUsed[BLOCKS];
+      memcpy(fileUsed, used, sizeof(used));
+      EXPECT_TRUE(markChain(eeFs.files[i].startBlk, fileUsed, blocks)) << "step " << steps << " file " << i;
+    }
+
+    // EeFsck() gives back the orphan blocks
+    EeFsck();
+    int total = 0;
+    memset(used, 0, sizeof(used));
+    for (int i=0; i<MAXFILES; i++) {
+      ASSERT_TRUE(markChain(eeFs.files[i].startBlk, used, count));
+      total += count;
+    }
+    ASSERT_TRUE(markChain(eeFs.modelIndex, used, count));
+    total += count;
+    ASSERT_TRUE(markChain(eeFs.freeList, used, count));
+    EXPECT_EQ(count, freeBlocks);
+    EXPECT_EQ(total + freeBlocks, BLOCKS - FIRSTBLK) << "step " << steps;
+
+    loadModel(id);
+    if (complete) {
+      EXPECT_EQ(freeBlocks, writerFreeBlocks);
+      EXPECT_EQ(memcmp(&g_model, data, sizeof(g_model)), 0);
+      break;
+    }
+    EXPECT_TRUE(!memcmp(&g_model, data, sizeof(g_model)) || !memcmp(&g_model, previous, sizeof(g_model))) << "step " << steps;
+  }
+
+  delete previous;
+  delete [] image;
+}
+
+TEST(EEPROM, interruptedWrites)
+{
+  eepromFile = NULL; // in memory
+
+  EeFsFormat();
+  for (int i=0; i<3; i++) {
+    modelDefault(i);
+    g_model.header.name[0] = i+1;
+    theFile.writeRlc(FILE_MODEL(i), FILE_TYP_MODEL, (uint8_t *)&g_model, sizeof(g_model), true);
+  }
+  eeLoadModelIndex();
+
+  // the file grows, blocks are taken from the free list
+  ModelData * data = new ModelData;
+  loadModel(1);
+  memcpy(data, &g_model, sizeof(g_model));
+  for (unsigned int i=0; i<sizeof(data->mixData); i++) {
+    ((uint8_t *)data->mixData)[i] = i*7+1;
+  }
+  checkInterruptedWrites(1, data);
+
+  // the file shrinks, the blocks left are given back to the free list
+  modelDefault(1);
+  memcpy(data, &g_model, sizeof(g_model));
+  checkInterruptedWrites(1, data);
+
+  delete data;
+}
+
+TEST(EEPROM, fileStorage)
+{
+  char path[] = "/tmp/eepromXXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+
+  StopEepromThread();
+  StartEepromThread(path);
+  uint8_t buf[100];
+  for (int i=0; i<100; i++) buf[i] = i;
+  eeWriteBlockCmp(buf, 1000, sizeof(buf));
+  memset(buf, 0, sizeof(buf));
+  eeprom_read_block(buf, 1000, sizeof(buf));
+  EXPECT_EQ(buf[99], 99);
+  StopEepromThread();
+  StartEepromThread(NULL);
+
+  FILE * f = fopen(path, "rb");
+  ASSERT_TRUE(f != NULL);
+  fseek(f, 0, SEEK_END);
+  EXPECT_GE(ftell(f), EESIZE);
+  fseek(f, 1099, SEEK_SET);
+  EXPECT_EQ(fgetc(f), 99);
+  fclose(f);
+  unlink(path);
+}
+
+TEST(EEPROM, modelIndex)
+{
+  eepromFile = NULL; // in memory
+
+  EeFsFormat();
+  for (int i=0; i<3; i++) {
+    modelDefault(i);
+    g_model.header.name[0] = i+1;
+    theFile.writeRlc(FILE_MODEL(i), FILE_TYP_MODEL, (uint8_t *)&g_model, sizeof(g_model), true);
+  }
+
+  eeLoadModelIndex();
+  EXPECT_NE(eeFs.modelIndex, 0);
+  EXPECT_EQ(modelHeaders[2].name[0], 3);
+
+  // a model save updates its entry
+  g_model.header.name[0] = 10;
+  theFile.writeRlc(FILE_MODEL(2), FILE_TYP_MODEL, (uint8_t *)&g_model, sizeof(g_model), true);
+  eeSwapModels(0, 1);
+  eeDeleteModel(2);
+
+  memset(modelHeaders, 0, sizeof(modelHeaders));
+  EeFsck();
+  eeprom_pages_written = 0;
+  eeLoadModelIndex();
+  EXPECT_EQ(eeprom_pages_written, 0u); // no entry was repaired
+  EXPECT_EQ(modelHeaders[0].name[0], 2);
+  EXPECT_EQ(modelHeaders[1].name[0], 1);
+  EXPECT_EQ(modelHeaders[2].name[0], 0);
+
+  // entries which don't match their model file are read again from the file
+  g_model.header.name[0] = 20;
+  theFile.writeRlc(FILE_MODEL(2), FILE_TYP_MODEL, (uint8_t *)&g_model, sizeof(g_model), true);
+  EFile::swap(FILE_MODEL(0), FILE_MODEL(2)); // the index isn't updated
+  memset(modelHeaders, 0, sizeof(modelHeaders));
+  eeLoadModelIndex();
+  EXPECT_EQ(modelHeaders[0].name[0], 20);
+  EXPECT_EQ(modelHeaders[2].name[0], 2);
+
+  // a stale entry is refused even when the model file is back on the same chain
+  uint8_t image[EEPROM_USED];
+  memcpy(image, eeprom, EEPROM_USED);
+  DirEnt file = eeFs.files[FILE_MODEL(0)];
+  g_model.header.name[0] = 21;
+  theFile.writeRlc(FILE_MODEL(0), FILE_TYP_MODEL, (uint8_t *)&g_model, sizeof(g_model), true);
+  g_model.header.name[0] = 22;
+  theFile.writeRlc(FILE_MODEL(0), FILE_TYP_MODEL, (uint8_t *)&g_model, sizeof(g_model), true);
+  ASSERT_EQ(memcmp(&eeFs.files[FILE_MODEL(0)], &file, sizeof(DirEnt)), 0);
+  for (blkid_t blk=eeFs.modelIndex; blk; blk=eepromLink(blk)) {
+    memcpy(&eeprom[blk*BS+BLOCKS_OFFSET], &image[blk*BS+BLOCKS_OFFSET], BS);
+  }
+  memset(modelHeaders, 0, sizeof(modelHeaders));
+  eeLoadModelIndex();
+  EXPECT_EQ(modelHeaders[0].name[0], 22);
+}
+#endif
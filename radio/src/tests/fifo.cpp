@@ -0,0 +1,159 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include "gtests.h"
+
+#if defined(CPUARM)
+TEST(Fifo, PushPop)
+{
+  Fifo<5> fifo;
+  uint8_t byte;
+  EXPECT_TRUE(fifo.empty());
+  EXPECT_FALSE(fifo.pop(byte));
+  for (int i=0; i<4; i++) {
+    EXPECT_TRUE(fifo.push(i));
+  }
+  EXPECT_FALSE(fifo.push(4));
+  EXPECT_EQ(fifo.size(), 4u);
+  EXPECT_EQ(fifo.getOverruns(), 1u);
+  EXPECT_EQ(fifo.getHighWater(), 4u);
+  for (int i=0; i<4; i++) {
+    EXPECT_TRUE(fifo.pop(byte));
+    EXPECT_EQ(byte, i);
+  }
+  EXPECT_TRUE(fifo.empty());
+}
+
+TEST(Fifo, PeekWrapsAround)
+{
+  Fifo<8> fifo;
+  uint8_t data[6] = { 1, 2, 3, 4, 5, 6 };
+  uint8_t out[6];
+  const uint8_t * region;
+
+  EXPECT_EQ(fifo.write(data, 6), 6u);
+  EXPECT_EQ(fifo.read(out, 5), 5u);
+  EXPECT_EQ(fifo.write(data, 6), 6u);
+  EXPECT_EQ(fifo.size(), 7u);
+
+  // 6 was written at index 5, then 1..2 at 6..7 and 3..6 at 0..3
+  EXPECT_EQ(fifo.peek(region), 3u);
+  EXPECT_EQ(region[0], 6);
+  EXPECT_EQ(region[1], 1);
+  EXPECT_EQ(region[2], 2);
+  fifo.skip(3);
+  EXPECT_EQ(fifo.peek(region), 4u);
+  EXPECT_EQ(region[0], 3);
+  fifo.skip(4);
+  EXPECT_TRUE(fifo.empty());
+
+  EXPECT_EQ(fifo.write(data, 6), 6u);
+  EXPECT_EQ(fifo.write(data, 6), 1u);
+  EXPECT_EQ(fifo.getOverruns(), 5u);
+  EXPECT_EQ(fifo.getHighWater(), 7u);
+}
+
+#define FIFO_STRESS_COUNT  200000
+
+static Fifo<61, uint32_t> stressFifo;
+
+static void * fifoProducer(void *)
+{
+  uint32_t value = 0;
+  uint32_t chunk[16];
+  while (value < FIFO_STRESS_COUNT) {
+    uint32_t count = 1 + (value % 13);
+    if (count > FIFO_STRESS_COUNT - value)
+      count = FIFO_STRESS_COUNT - value;
+    for (uint32_t i=0; i<count; i++) {
+      chunk[i] = value + i;
+    }
+    uint32_t written = 0;
+    if (count == 1) {
+      if (stressFifo.push(value))
+        written = 1;
+    }
+    else {
+      written = stressFifo.write(chunk, count);
+    }
+    if (written == 0)
+      sched_yield();
+    value += written;
+  }
+  return NULL;
+}
+
+TEST(Fifo, ProducerConsumerThreads)
+{
+  pthread_t producer;
+  uint32_t expected = 0;
+  bool ordered = true;
+
+  ASSERT_EQ(pthread_create(&producer, NULL, fifoProducer, NULL), 0);
+  while (expected < FIFO_STRESS_COUNT) {
+    const uint32_t * region;
+    uint32_t buffer[7];
+    uint32_t count;
+    if (expected & 1) {
+      count = stressFifo.peek(region);
+      for (uint32_t i=0; i<count; i++) {
+        if (region[i] != expected++)
+          ordered = false;
+      }
+      stressFifo.skip(count);
+    }
+    else {
+      count = stressFifo.read(buffer, 7);
+      for (uint32_t i=0; i<count; i++) {
+        if (buffer[i] != expected++)
+          ordered = false;
+      }
+    }
+    if (!ordered)
+      break;
+    if (count == 0)
+      sched_yield();
+  }
+  pthread_join(producer, NULL);
+
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(expected, (uint32_t)FIFO_STRESS_COUNT);
+  EXPECT_TRUE(stressFifo.empty());
+  EXPECT_LE(stressFifo.getHighWater(), 60u);
+}
+#endif
@@ -34,6 +34,7 @@
  *
  */
 
+#include <time.h>
 #include "gtests.h"
 
 #if defined(FRSKY) && !defined(CPUARM)
@@ -435,6 +436,292 @@ TEST(FrSkySPORT, frskyCurrent)
 }
 #endif
 
+TEST(FrSkySPORT, sensorsTableSorted)
+{
+  int count = 0;
+  for (const FrSkySportSensor * sensor = sportSensors; sensor->firstId; sensor++, count++) {
+    EXPECT_LE(sensor->firstId, sensor->lastId);
+    if (count > 0) {
+      EXPECT_GT(sensor->firstId, (sensor-1)->lastId);
+    }
+  }
+
+  for (uint32_t id=0; id<=0xFFFF; id++) {
+    const FrSkySportSensor * expected = NULL;
+    for (const FrSkySportSensor * sensor = sportSensors; sensor->firstId; sensor++) {
+      if (id >= sensor->firstId && id <= sensor->lastId) {
+        expected = sensor;
+        break;
+      }
+    }
+    EXPECT_EQ(getFrSkySportSensor(id), expected);
+  }
+
+  for (const FrSkyDSensor * sensor = frskyDSensors; sensor->id; sensor++) {
+    if (sensor != frskyDSensors) {
+      EXPECT_GT(sensor->id, (sensor-1)->id);
+    }
+    EXPECT_EQ(getFrSkyDSensor(sensor->id), sensor);
+  }
+  EXPECT_EQ(getFrSkyDSensor(0x07), (const FrSkyDSensor *)NULL);
+}
+
+TEST(FrSkySPORT, checkCrcFolded)
+{
+  uint8_t packet[FRSKY_SPORT_PACKET_SIZE];
+  for (int n=0; n<10000; n++) {
+    for (int i=0; i<FRSKY_SPORT_PACKET_SIZE; i++) {
+      packet[i] = rand();
+    }
+    if (n & 1) {
+      setSportPacketCrc(packet);
+    }
+    // the byte by byte end-around carry sum
+    short crc = 0;
+    for (int i=1; i<FRSKY_SPORT_PACKET_SIZE; ++i) {
+      crc += packet[i];
+      crc += crc >> 8;
+      crc &= 0x00ff;
+    }
+    EXPECT_EQ(checkSportPacket(packet), crc == 0x00ff);
+  }
+}
+
+static uint64_t getMicroseconds()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+TEST(FrSkySPORT, decodingBenchmark)
+{
+  const uint16_t appIds[] = { ALT_FIRST_ID, VARIO_FIRST_ID, CURR_FIRST_ID, VFAS_FIRST_ID, RPM_FIRST_ID, GPS_ALT_FIRST_ID, AIR_SPEED_FIRST_ID, ADC2_ID };
+  const int count = 200000;
+  uint8_t packets[DIM(appIds)][FRSKY_SPORT_PACKET_SIZE];
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  for (unsigned int i=0; i<DIM(appIds); i++) {
+    packets[i][0] = 0x98;
+    packets[i][1] = 0x10; // DATA_FRAME
+    *((uint16_t *)(packets[i]+2)) = appIds[i];
+    *((int32_t *)(packets[i]+4)) = 1000 + i;
+    setSportPacketCrc(packets[i]);
+  }
+
+  uint64_t start = getMicroseconds();
+  int found = 0;
+  for (int n=0; n<count; n++) {
+    uint8_t * packet = packets[n % DIM(appIds)];
+    if (checkSportPacket(packet) && getFrSkySportSensor(*((uint16_t *)(packet+2))))
+      found++;
+  }
+  uint64_t lookup = getMicroseconds() - start;
+  EXPECT_EQ(found, count);
+
+  start = getMicroseconds();
+  for (int n=0; n<count; n++) {
+    processSportPacket(packets[n % DIM(appIds)]);
+  }
+  uint64_t decode = getMicroseconds() - start;
+
+  printf("S.PORT crc + sensor lookup: %d ns/packet, full decoding: %d ns/packet\n", int(lookup * 1000 / count), int(decode * 1000 / count));
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    telemetryItems[i].clear();
+  }
+}
+
+// a byte stuffed S.PORT frame, as received on the wire
+int generateSportFrame(uint8_t * frame, uint16_t appId, uint32_t data)
+{
+  uint8_t packet[FRSKY_SPORT_PACKET_SIZE];
+  int len = 0;
+
+  packet[0] = 0x98;
+  packet[1] = 0x10; // DATA_FRAME
+  *((uint16_t *)(packet+2)) = appId;
+  *((uint32_t *)(packet+4)) = data;
+  setSportPacketCrc(packet);
+
+  frame[len++] = START_STOP;
+  for (int i=0; i<FRSKY_SPORT_PACKET_SIZE; i++) {
+    if (packet[i] == START_STOP || packet[i] == BYTESTUFF) {
+      frame[len++] = BYTESTUFF;
+      frame[len++] = packet[i] ^ STUFF_MASK;
+    }
+    else {
+      frame[len++] = packet[i];
+    }
+  }
+  return len;
+}
+
+TEST(FrSkySPORT, recordAndReplay)
+{
+  const char * filename = "telemetry_replay_test" TELEMETRY_RECORD_EXT;
+  uint8_t frame[2*FRSKY_SPORT_PACKET_SIZE+1];
+  int len;
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    telemetryItems[i].clear();
+  }
+
+  // 1 frame every 12ms, with a 10s silence in the middle
+  ASSERT_TRUE(telemetryRecorderStart(filename, PROTOCOL_FRSKY_SPORT));
+  uint32_t time = getTelemetryRecorderTime();
+  for (int n=0; n<100; n++) {
+    time += 12 * 2000;
+    if (n == 50)
+      time += 10 * 2000000;
+    if (n % 10 == 0)
+      len = generateSportFrame(frame, RSSI_ID, 80);
+    else
+      len = generateSportFrame(frame, VFAS_FIRST_ID, 2000 - n);
+    // the frame is split between 2 chunks, as the fifo may give it
+    telemetryRecorderWrite(time, frame, 4);
+    telemetryRecorderWrite(time, frame+4, len-4);
+  }
+  telemetryRecorderStop();
+  EXPECT_FALSE(isTelemetryRecorderRunning());
+
+  ASSERT_TRUE(telemetryReplay.open(filename));
+  EXPECT_EQ(telemetryProtocol, PROTOCOL_FRSKY_SPORT);
+
+  // up to the silence
+  telemetryReplay.feed(51 * 12 * 2000);
+  int index = availableTelemetryIndex() - 1;
+  ASSERT_GE(index, 0);
+  EXPECT_EQ(g_model.telemetrySensors[index].id, VFAS_FIRST_ID);
+  EXPECT_EQ(telemetryItems[index].value, 1951);
+  EXPECT_FALSE(telemetryReplay.isFinished());
+
+  telemetryReplay.feed(0xFFFFFFFF);
+  EXPECT_TRUE(telemetryReplay.isFinished());
+  EXPECT_EQ(telemetryItems[index].value, 1901);
+  EXPECT_EQ(telemetryItems[index].valueMin, 1901);
+  EXPECT_EQ(telemetryItems[index].valueMax, 1999);
+  telemetryReplay.close();
+  remove(filename);
+
+  MODEL_RESET();
+  TELEMETRY_RESET();
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    telemetryItems[i].clear();
+  }
+}
+
 #endif  //#if defined(FRSKY_SPORT)
 
+#if defined(CPUARM)
+TEST(Telemetry, MixerReadsPublishedSnapshot)
+{
+  telemetryItems[0].clear();
+  telemetryPublishSnapshot();
+  telemetryItems[0].value = 1234;
+  telemetryItems[0].valueMax = 2000;
+  EXPECT_EQ(getValue(MIXSRC_FIRST_TELEM), 0);
+
+  telemetryPublishSnapshot();
+  EXPECT_EQ(getValue(MIXSRC_FIRST_TELEM), 1234);
+  EXPECT_EQ(getValue(MIXSRC_FIRST_TELEM+2), 2000);
+
+  telemetryItems[0].clear();
+  telemetryPublishSnapshot();
+}
+
+TEST(Telemetry, FormulasDependencyOrder)
+{
+  MODEL_RESET();
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    telemetryItems[i].clear();
+  }
+
+  // sensor 2 = sensor 3 + sensor 1, and sensor 3 = sensor 1 + sensor 1
+  g_model.telemetrySensors[0].init("Cur1", UNIT_AMPS);
+  g_model.telemetrySensors[1].init("Sum2", UNIT_AMPS);
+  g_model.telemetrySensors[1].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[1].formula = TELEM_FORMULA_ADD;
+  g_model.telemetrySensors[1].calc.sources[0] = 3;
+  g_model.telemetrySensors[1].calc.sources[1] = 1;
+  g_model.telemetrySensors[2].init("Sum1", UNIT_AMPS);
+  g_model.telemetrySensors[2].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[2].formula = TELEM_FORMULA_ADD;
+  g_model.telemetrySensors[2].calc.sources[0] = 1;
+  g_model.telemetrySensors[2].calc.sources[1] = 1;
+  telemetryInvalidateFormulas();
+
+  telemetryItems[0].setValue(g_model.telemetrySensors[0], 10, UNIT_AMPS);
+  telemetryEvalFormulas();
+  EXPECT_EQ(telemetryItems[2].value, 20);
+  EXPECT_EQ(telemetryItems[1].value, 30);
+
+  // nothing received, nothing evaluated
+  telemetryItems[1].value = 0;
+  telemetryEvalFormulas();
+  EXPECT_EQ(telemetryItems[1].value, 0);
+
+  telemetryItems[0].setValue(g_model.telemetrySensors[0], 5, UNIT_AMPS);
+  telemetryEvalFormulas();
+  EXPECT_EQ(telemetryItems[1].value, 15);
+
+  MODEL_RESET();
+  telemetryInvalidateFormulas();
+  for (int i=0; i<TELEM_VALUES_MAX; i++) {
+    telemetryItems[i].clear();
+  }
+}
+
+#if defined(FRSKY)
+TEST(Telemetry, FormulasRebuiltAfterModelChange)
+{
+  MODEL_RESET();
+  telemetryReset();
+  telemetryEvalFormulas();
+
+  // another model is loaded with a calculated sensor, then the telemetry is reset
+  g_model.telemetrySensors[0].init("Cur1", UNIT_AMPS);
+  g_model.telemetrySensors[3].init("Sum1", UNIT_AMPS);
+  g_model.telemetrySensors[3].type = TELEM_TYPE_CALCULATED;
+  g_model.telemetrySensors[3].formula = TELEM_FORMULA_ADD;
+  g_model.telemetrySensors[3].calc.sources[0] = 1;
+  g_model.telemetrySensors[3].calc.sources[1] = 1;
+  telemetryReset();
+
+  telemetryItems[0].setValue(g_model.telemetrySensors[0], 10, UNIT_AMPS);
+  telemetryEvalFormulas();
+  EXPECT_EQ(telemetryItems[3].value, 20);
+
+  MODEL_RESET();
+  telemetryReset();
+}
+#endif
+
+TEST(Telemetry, FormulaChanged)
+{
+  TelemetrySensor sensor;
+  memclear(&sensor, sizeof(sensor));
+  sensor.type = TELEM_TYPE_CALCULATED;
+  sensor.formula = TELEM_FORMULA_ADD;
+  sensor.calc.sources[0] = 1;
+  TelemetrySensor previous = sensor;
+
+  strncpy(sensor.label, "Sum", TELEM_LABEL_LEN);
+  sensor.prec = 1;
+  EXPECT_FALSE(isTelemetryFormulaChanged(previous, sensor));
+
+  sensor.calc.sources[1] = 2;
+  EXPECT_TRUE(isTelemetryFormulaChanged(previous, sensor));
+
+  sensor = previous;
+  sensor.formula = TELEM_FORMULA_MAX;
+  EXPECT_TRUE(isTelemetryFormulaChanged(previous, sensor));
+}
+#endif
+
 
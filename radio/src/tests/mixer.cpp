@@ -930,6 +930,27 @@ TEST(Mixer, SlowOnMultiply)
 }
 
 
+#if defined(CPUARM)
+TEST(Mixer, PublishedChannelOutputsFrame)
+{
+  MODEL_RESET();
+  modelDefault(0);
+  anaInValues[THR_STICK] = +1024;
+  uint32_t sequence = channelOutputsSequence;
+  evalMixes(1);
+  EXPECT_EQ(channelOutputsSequence, sequence+1);
+  EXPECT_EQ(getChannelOutputsFrame()[2], 1024);
+  anaInValues[THR_STICK] = -1024;
+  evalMixes(1);
+  EXPECT_EQ(getChannelOutputsFrame()[2], -1024);
+  // the previous frame is left untouched until the next mixer run
+  EXPECT_EQ(channelOutputsFrames[(sequence+1) & 1].values[2], 1024);
+  int16_t channels[NUM_CHNOUT];
+  readChannelOutputsFrame(channels, 0, NUM_CHNOUT);
+  EXPECT_EQ(memcmp(channels, channelOutputs, sizeof(channels)), 0);
+}
+#endif
+
 #if defined(HELI) && defined(VIRTUALINPUTS)
 TEST(Heli, BasicTest)
 {
@@ -1020,3 +1041,78 @@ TEST(Trainer, UnpluggedTest)
   g_ppmIns[0] = 1024;
   CHECK_DELAY(0, 5000);
 }
+
+#if defined(PCBTARANIS)
+void buildSbusFrame(uint8_t * frame, const uint16_t * channels, uint8_t flags)
+{
+  memclear(frame, SBUS_FRAME_SIZE);
+  frame[0] = 0x0F;
+  for (int i=0; i<16; i++) {
+    for (int bit=0; bit<11; bit++) {
+      if (channels[i] & (1 << bit)) {
+        int pos = i*11 + bit;
+        frame[1 + pos/8] |= 1 << (pos % 8);
+      }
+    }
+  }
+  frame[23] = flags;
+}
+
+TEST(Trainer, SbusFrame)
+{
+  uint8_t frame[SBUS_FRAME_SIZE];
+  uint16_t channels[16];
+  int16_t pulses[NUM_TRAINER];
+
+  srand(0x1234);
+  for (int test=0; test<100; test++) {
+    for (int i=0; i<16; i++) {
+      channels[i] = rand() & 0x7FF;
+    }
+    buildSbusFrame(frame, channels, 0);
+    ppmInValid = 0;
+    processSbusFrame(frame, pulses, SBUS_FRAME_SIZE);
+    EXPECT_EQ(ppmInValid, PPM_IN_VALID_TIMEOUT);
+    for (int i=0; i<NUM_TRAINER; i++) {
+      EXPECT_EQ(pulses[i], ((int32_t)channels[i] - 0x3E0) * 5 / 8);
+    }
+  }
+
+  // failsafe frames are counted and ignored
+  uint32_t failsafes = sbusStatistics.failsafes;
+  buildSbusFrame(frame, channels, 0x08);
+  ppmInValid = 0;
+  processSbusFrame(frame, pulses, SBUS_FRAME_SIZE);
+  EXPECT_EQ(ppmInValid, 0);
+  EXPECT_EQ(sbusStatistics.failsafes, failsafes+1);
+}
+
+TEST(Trainer, SbusDmaRing)
+{
+  uint8_t frame[SBUS_FRAME_SIZE];
+  uint16_t channels[16];
+  for (int i=0; i<16; i++) {
+    channels[i] = 0x3E0 + 8*i;
+  }
+  buildSbusFrame(frame, channels, 0);
+
+  // simulate a lost byte, then frames wrapping in the DMA ring
+  memclear(&sbusDmaRing, sizeof(sbusDmaRing));
+  memclear(&sbusStatistics, sizeof(sbusStatistics));
+  uint32_t writeIndex = 0;
+  for (int count=0; count<5; count++) {
+    memclear(g_ppmIns, sizeof(g_ppmIns));
+    uint32_t size = (count == 0 ? SBUS_FRAME_SIZE-1 : SBUS_FRAME_SIZE);
+    for (uint32_t i=0; i<size; i++) {
+      sbusDmaRing.buffer[writeIndex] = frame[i];
+      writeIndex = (writeIndex + 1) % SBUS_DMA_BUFFER_SIZE;
+    }
+    processSbusDmaRing(writeIndex, false);
+    for (int i=0; i<NUM_TRAINER; i++) {
+      // the truncated frame is rejected
+      EXPECT_EQ(g_ppmIns[i], count == 0 ? 0 : 5*i);
+    }
+  }
+  EXPECT_EQ(sbusStatistics.errors, 1u);
+}
+#endif
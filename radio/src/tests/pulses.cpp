@@ -0,0 +1,224 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "gtests.h"
+
+#if defined(PXX) && defined(CPUARM)
+
+void setupPulsesPXX(unsigned int port);
+
+#if defined(PCBTARANIS)
+typedef uint16_t pxx_stream_t;
+#define PXX_STREAM_SIZE 400
+#else
+typedef uint8_t pxx_stream_t;
+#define PXX_STREAM_SIZE 64
+#endif
+
+extern pxx_stream_t pxxStream[NUM_MODULES][PXX_STREAM_SIZE];
+extern pxx_stream_t *pxxStreamPtr[NUM_MODULES];
+
+// The bit by bit encoder the table driven one must stay identical to
+class PxxReferenceEncoder {
+  public:
+    pxx_stream_t stream[PXX_STREAM_SIZE];
+    pxx_stream_t * ptr;
+
+    PxxReferenceEncoder():
+      ptr(stream),
+      value(0),
+      crc(0),
+      onesCount(0),
+      serialByte(0),
+      serialBitCount(0)
+    {
+    }
+
+    void putFrame(const uint8_t * data, int len)
+    {
+      for (int i=0; i<4; i++) {
+        putPart(0);
+      }
+      putHead();
+      for (int i=0; i<len; i++) {
+        putByte(data[i]);
+      }
+      uint16_t frameCrc = crc;
+      putByte(frameCrc >> 8);
+      putByte(frameCrc);
+      putHead();
+      putFlush();
+    }
+
+  protected:
+    uint16_t value;
+    uint16_t crc;
+    uint8_t onesCount;
+    uint8_t serialByte;
+    uint8_t serialBitCount;
+
+#if defined(PCBTARANIS)
+    void putPart(uint8_t bit)
+    {
+      value += 18;
+      *ptr++ = value;
+      value += (bit ? 30 : 14);
+      *ptr++ = value;
+    }
+
+    void putFlush()
+    {
+      *ptr++ = 18010;
+    }
+#else
+    void putSerialBit(uint8_t bit)
+    {
+      serialByte >>= 1;
+      if (bit & 1) {
+        serialByte |= 0x80;
+      }
+      if (++serialBitCount >= 8) {
+        *ptr++ = serialByte;
+        serialBitCount = 0;
+      }
+    }
+
+    void putPart(uint8_t bit)
+    {
+      putSerialBit(0);
+      if (bit) {
+        putSerialBit(0);
+      }
+      putSerialBit(1);
+    }
+
+    void putFlush()
+    {
+      while (serialBitCount != 0) {
+        putSerialBit(1);
+      }
+    }
+#endif
+
+    void putBit(uint8_t bit)
+    {
+      if (bit) {
+        onesCount += 1;
+        putPart(1);
+      }
+      else {
+        onesCount = 0;
+        putPart(0);
+      }
+      if (onesCount >= 5) {
+        putBit(0);
+      }
+    }
+
+    void putByte(uint8_t byte)
+    {
+      uint16_t entry = (crc>>8) ^ byte;
+      for (uint8_t i=0; i<8; i++) {
+        entry = (entry & 1) ? ((entry >> 1) ^ 0x8408) : (entry >> 1);
+      }
+      crc = (crc<<8) ^ entry;
+      for (uint8_t i=0; i<8; i++) {
+        putBit(byte & 0x80);
+        byte <<= 1;
+      }
+    }
+
+    void putHead()
+    {
+      putPart(0);
+      for (int i=0; i<6; i++) {
+        putPart(1);
+      }
+      putPart(0);
+    }
+};
+
+TEST(Pxx, TableEncoderMatchesBitEncoder)
+{
+  MODEL_RESET();
+  g_model.header.modelId = 3;
+  g_model.moduleData[EXTERNAL_MODULE].failsafeMode = FAILSAFE_RECEIVER;
+  int16_t * channels = channelOutputsFrames[channelOutputsSequence & 1].values;
+
+  srand(0x5678);
+  for (int test=0; test<1000; test++) {
+    uint8_t frame[16];
+    frame[0] = g_model.header.modelId;
+    frame[1] = 0;
+    frame[2] = 0;
+    uint16_t chan_low = 0;
+    for (int i=0; i<8; i++) {
+      // some full scale and centered values to get long runs of ones
+      switch (rand() % 4) {
+        case 0:
+          channels[i] = 0;
+          break;
+        case 1:
+          channels[i] = (rand() & 1) ? 1536 : -1536;
+          break;
+        default:
+          channels[i] = (rand() % 3073) - 1536;
+          break;
+      }
+      uint16_t chan = limit(1, PPM_CH_CENTER(i) - PPM_CENTER + (channels[i] * 512 / 682) + 1024, 2046);
+      if (i & 1) {
+        frame[3+(i/2)*3] = chan_low;
+        frame[4+(i/2)*3] = ((chan_low >> 8) & 0x0F) | (chan << 4);
+        frame[5+(i/2)*3] = chan >> 4;
+      }
+      else {
+        chan_low = chan;
+      }
+    }
+    frame[15] = 0;
+
+    PxxReferenceEncoder reference;
+    reference.putFrame(frame, sizeof(frame));
+
+    setupPulsesPXX(EXTERNAL_MODULE);
+
+    int len = reference.ptr - reference.stream;
+    ASSERT_EQ(pxxStreamPtr[EXTERNAL_MODULE] - pxxStream[EXTERNAL_MODULE], len);
+    ASSERT_EQ(memcmp(pxxStream[EXTERNAL_MODULE], reference.stream, len*sizeof(pxx_stream_t)), 0);
+  }
+}
+
+#endif // #if defined(PXX) && defined(CPUARM)
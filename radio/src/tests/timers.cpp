@@ -45,6 +45,7 @@ struct TimerState {
   uint8_t  state;
   int16_t  val;
   uint8_t  val_10ms;
+  int16_t  announce;
 };
 
 PACK(typedef struct t_TimerData {
@@ -282,3 +283,128 @@ TEST(Timers, timerThrottleTriggered)
   EXPECT_TRUE(evalTimersForNSecondsAndTest(10,         0, 0, TMR_NEGATIVE,-11));
   EXPECT_TRUE(evalTimersForNSecondsAndTest(100,        0, 0, TMR_STOPPED,-111));
 }
+
+TEST(Timers, saturatedTimerDoesntHoldOthers)
+{
+  memset(g_model.timers, 0, sizeof(g_model.timers));
+  g_model.timers[0].mode = TMRMODE_ABS;
+  g_model.timers[1].mode = TMRMODE_ABS;
+  timerSet(0, TIMER_MAX);
+  timerReset(1);
+
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(10, THR_100, 0, TMR_RUNNING, TIMER_MAX));
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(0,  THR_100, 1, TMR_RUNNING, 10));
+}
+
+#if defined(CPUARM) || defined(CPUM2560)
+TEST(Timers, restoreNegativeTimer)
+{
+  initModelTimer(0, TMRMODE_ABS, 100);
+  g_model.timers[0].persistent = 1;
+  timerReset(0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(110, THR_100, 0, TMR_NEGATIVE, -10));
+  saveTimers();
+  EXPECT_EQ((int16_t)g_model.timers[0].value, -10);
+
+  timerReset(0);
+  restoreTimers();
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(1, THR_100, 0, TMR_NEGATIVE, -11));
+
+  g_model.timers[0].value = -MAX_ALERT_TIME;
+  timerReset(0);
+  restoreTimers();
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(1, THR_100, 0, TMR_STOPPED, -MAX_ALERT_TIME-1));
+}
+#endif
+
+TEST(Timers, simuStateSnapshot)
+{
+  MODEL_RESET();
+  initModelTimer(0, TMRMODE_ABS, 0);
+  timerReset(0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(10, THR_100, 0, TMR_RUNNING, 10));
+
+  uint8_t * state = (uint8_t *)malloc(simuStateSize());
+  simuSaveState(state);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(20, THR_100, 0, TMR_RUNNING, 30));
+  g_model.timers[0].mode = TMRMODE_NONE;
+
+  simuRestoreState(state);
+  free(state);
+  EXPECT_EQ(g_model.timers[0].mode, TMRMODE_ABS);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(5, THR_100, 0, TMR_RUNNING, 15));
+}
+
+#define EXPECT_ANNOUNCES(idx, minute, t30, t20, lt10) \
+  EXPECT_EQ(timersAnnounces[idx][TIMER_ANNOUNCE_MINUTE], minute); \
+  EXPECT_EQ(timersAnnounces[idx][TIMER_ANNOUNCE_30], t30); \
+  EXPECT_EQ(timersAnnounces[idx][TIMER_ANNOUNCE_20], t20); \
+  EXPECT_EQ(timersAnnounces[idx][TIMER_ANNOUNCE_LT10], lt10)
+
+void initAnnouncedTimer(uint8_t mode, int16_t start)
+{
+  memset(g_model.timers, 0, sizeof(g_model.timers));
+  memset(timersAnnounces, 0, sizeof(timersAnnounces));
+  initModelTimer(0, mode, start);
+  g_model.timers[0].countdownBeep = COUNTDOWN_BEEPS;
+  g_model.timers[0].minuteBeep = 1;
+  timerReset(0);
+}
+
+TEST(Timers, announcesCountDown)
+{
+  initAnnouncedTimer(TMRMODE_ABS, 150);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(31, THR_100, 0, TMR_RUNNING, 119));
+  EXPECT_ANNOUNCES(0, 1, 0, 0, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(89, THR_100, 0, TMR_RUNNING, 30));
+  EXPECT_ANNOUNCES(0, 2, 1, 0, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(10, THR_100, 0, TMR_RUNNING, 20));
+  EXPECT_ANNOUNCES(0, 2, 1, 1, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(20, THR_100, 0, TMR_NEGATIVE, 0));
+  EXPECT_ANNOUNCES(0, 2, 1, 1, 10);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(20, THR_100, 0, TMR_NEGATIVE, -20));
+  EXPECT_ANNOUNCES(0, 2, 1, 1, 10);
+
+  // no countdown beeps when silent
+  initAnnouncedTimer(TMRMODE_ABS, 150);
+  g_model.timers[0].countdownBeep = COUNTDOWN_SILENT;
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(150, THR_100, 0, TMR_NEGATIVE, 0));
+  EXPECT_ANNOUNCES(0, 2, 0, 0, 0);
+}
+
+TEST(Timers, announcesCountUp)
+{
+  initAnnouncedTimer(TMRMODE_ABS, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(59, THR_100, 0, TMR_RUNNING, 59));
+  EXPECT_ANNOUNCES(0, 0, 0, 0, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(1, THR_100, 0, TMR_RUNNING, 60));
+  EXPECT_ANNOUNCES(0, 1, 0, 0, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(125, THR_100, 0, TMR_RUNNING, 185));
+  EXPECT_ANNOUNCES(0, 3, 0, 0, 0);
+
+  // the throttle timer stays silent while it doesn't count
+  initAnnouncedTimer(TMRMODE_THR, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(100, 0, 0, TMR_RUNNING, 0));
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(60, THR_100, 0, TMR_RUNNING, 60));
+  EXPECT_ANNOUNCES(0, 1, 0, 0, 0);
+}
+
+// what the model setup menus do when the start is edited
+#define EDIT_TIMER_START(idx, value) { g_model.timers[idx].start = value; timersStates[idx].announce = TIMER_MIN; }
+
+TEST(Timers, announcesAfterStartChange)
+{
+  initAnnouncedTimer(TMRMODE_ABS, 100);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(10, THR_100, 0, TMR_RUNNING, 90));
+
+  // the count down becomes a count up from 1:30
+  EDIT_TIMER_START(0, 0);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(30, THR_100, 0, TMR_RUNNING, 120));
+  EXPECT_ANNOUNCES(0, 1, 0, 0, 0);
+
+  // and back to a count down from 2:00, the elapsed time is kept
+  EDIT_TIMER_START(0, 240);
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(1, THR_100, 0, TMR_RUNNING, 119));
+  EXPECT_TRUE(evalTimersForNSecondsAndTest(119, THR_100, 0, TMR_NEGATIVE, 0));
+  EXPECT_ANNOUNCES(0, 2, 1, 1, 10);
+}
@@ -49,6 +49,7 @@ void timerReset(uint8_t idx)
   timerState.state = TMR_OFF; // is changed to RUNNING dep from mode
   timerState.val = g_model.timers[idx].start;
   timerState.val_10ms = 0 ;
+  timerState.announce = TIMER_MIN;
 }
 
 #if defined(CPUARM)
@@ -58,6 +59,7 @@ void timerSet(int idx, int16_t val)
   timerState.state = TMR_OFF; // is changed to RUNNING dep from mode
   timerState.val = val;
   timerState.val_10ms = 0 ;
+  timerState.announce = TIMER_MIN;
 }
 #endif // #if defined(CPUARM)
 
@@ -67,6 +69,7 @@ void restoreTimers()
   for (uint8_t i=0; i<TIMERS; i++) {
     if (g_model.timers[i].persistent) {
       timersStates[i].val = g_model.timers[i].value;
+      timersStates[i].announce = TIMER_MIN;
     }
   }
 }
@@ -76,7 +79,7 @@ void saveTimers()
   for (uint8_t i=0; i<TIMERS; i++) {
     if (g_model.timers[i].persistent) {
       TimerState *timerState = &timersStates[i];
-      if (g_model.timers[i].value != (uint16_t)timerState->val) {
+      if ((int16_t)g_model.timers[i].value != timerState->val) {
         g_model.timers[i].value = timerState->val;
         eeDirty(EE_MODEL);
       }
@@ -95,117 +98,177 @@ void saveTimers()
 
 #if defined(ACCURAT_THROTTLE_TIMER)
   #define THR_TRG_TRESHOLD    13      // approximately 10% full throttle
+  #define THR_REL_SHIFT       7       // throttle was normalized to 0 to 128 value
 #else
   #define THR_TRG_TRESHOLD    3       // approximately 10% full throttle
+  #define THR_REL_SHIFT       5       // throttle was normalized to 0 to 32 value
 #endif
 
+static void timerStart(uint8_t idx)
+{
+  TimerState * timerState = &timersStates[idx];
+  uint16_t tv = g_model.timers[idx].start;
+
+  // a persistent timer may be restored past zero, don't announce it again
+  timerState->state = TMR_RUNNING;
+  if (tv) {
+    int16_t elapsed = tv - timerState->val;
+    if (elapsed >= (int16_t)tv + MAX_ALERT_TIME)
+      timerState->state = TMR_STOPPED;
+    else if (elapsed >= (int16_t)tv)
+      timerState->state = TMR_NEGATIVE;
+  }
+  timerState->cnt = 0;
+  timerState->sum = 0;
+  timerState->announce = TIMER_MIN;
+}
+
+// Next value after val at which a running timer may have something to announce:
+// the minutes, 30s, 20s and each second below 10s when counting down, the minutes when counting up
+static int16_t timerNextAnnounce(uint16_t tv, int32_t val)
+{
+  if (tv) {
+    if (val > 60) return ((val-1) / 60) * 60;
+    if (val > 30) return 30;
+    if (val > 20) return 20;
+    if (val > 10) return 10;
+    return (val > 0 ? val-1 : 0);
+  }
+  else {
+    int32_t next = (val >= 0 ? (val/60 + 1) * 60 : -((-val-1) / 60) * 60);
+    return (next > TIMER_MAX ? TIMER_MAX : next);
+  }
+}
+
+#if defined(SIMU)
+uint16_t timersAnnounces[TIMERS][TIMER_ANNOUNCE_COUNT];
+#define TIMER_ANNOUNCED(idx, what) timersAnnounces[idx][what]++
+#else
+#define TIMER_ANNOUNCED(idx, what)
+#endif
+
+static void timerAnnounce(uint8_t idx, int16_t val)
+{
+  TimerData & timer = g_model.timers[idx];
+
+  if (timer.countdownBeep && timer.start) {
+    if (val==30) {
+      AUDIO_TIMER_30();
+      TIMER_ANNOUNCED(idx, TIMER_ANNOUNCE_30);
+      TRACE("Timer[%d] 30s announcement", idx);
+    }
+    if (val==20) {
+      AUDIO_TIMER_20();
+      TIMER_ANNOUNCED(idx, TIMER_ANNOUNCE_20);
+      TRACE("Timer[%d] 20s announcement", idx);
+    }
+    if (val<=10) {
+      AUDIO_TIMER_LT10(timer.countdownBeep, val);
+      TIMER_ANNOUNCED(idx, TIMER_ANNOUNCE_LT10);
+      TRACE("Timer[%d] %ds announcement", idx, val);
+    }
+  }
+  if (timer.minuteBeep && (val % 60)==0) {
+    AUDIO_TIMER_MINUTE(val);
+    TIMER_ANNOUNCED(idx, TIMER_ANNOUNCE_MINUTE);
+    TRACE("Timer[%d] %d minute announcement", idx, val/60);
+  }
+}
+
 void evalTimers(int16_t throttle, uint8_t tick10ms)
 {
   for (uint8_t i=0; i<TIMERS; i++) {
     int8_t tm = g_model.timers[i].mode;
-    uint16_t tv = g_model.timers[i].start;
     TimerState * timerState = &timersStates[i];
 
-    if (tm) {
-      if ((timerState->state == TMR_OFF) && (tm != TMRMODE_THR_TRG)) {
-        timerState->state = TMR_RUNNING;
-        timerState->cnt = 0;
-        timerState->sum = 0;
-      }
+    if (!tm)
+      continue;
 
-      if (tm == TMRMODE_THR_REL) {
-        timerState->cnt++;
-        timerState->sum += throttle;
-      }
+    if ((timerState->state == TMR_OFF) && (tm != TMRMODE_THR_TRG)) {
+      timerStart(i);
+    }
 
-      if ((timerState->val_10ms += tick10ms) >= 100) {
-        if (timerState->val == TIMER_MAX) break;
-        if (timerState->val == TIMER_MIN) break;
+    if (tm == TMRMODE_THR_REL) {
+      timerState->cnt++;
+      timerState->sum += throttle;
+    }
 
-        timerState->val_10ms -= 100 ;
-        int16_t newTimerVal = timerState->val;
-        if (tv) newTimerVal = tv - newTimerVal;
+    // nothing else to do until the next second
+    if ((timerState->val_10ms += tick10ms) < 100)
+      continue;
 
-        if (tm == TMRMODE_ABS) {
-          newTimerVal++;
-        }
-        else if (tm == TMRMODE_THR) {
-          if (throttle) newTimerVal++;
-        }
-        else if (tm == TMRMODE_THR_REL) {
-          // @@@ open.20.fsguruh: why so complicated? we have already a s_sum field; use it for the half seconds (not showable) as well
-          // check for s_cnt[i]==0 is not needed because we are shure it is at least 1
-  #if defined(ACCURAT_THROTTLE_TIMER)
-          if ((timerState->sum/timerState->cnt) >= 128) {  // throttle was normalized to 0 to 128 value (throttle/64*2 (because - range is added as well)
-            newTimerVal++;  // add second used of throttle
-            timerState->sum -= 128*timerState->cnt;
-          }
-  #else
-          if ((timerState->sum/timerState->cnt) >= 32) {  // throttle was normalized to 0 to 32 value (throttle/16*2 (because - range is added as well)
-            newTimerVal++;  // add second used of throttle
-            timerState->sum -= 32*timerState->cnt;
-          }
-  #endif
-          timerState->cnt=0;
-        }
-        else if (tm == TMRMODE_THR_TRG) {
-          // we can't rely on (throttle || newTimerVal > 0) as a detection if timer should be running
-          // because having persistent timer brakes this rule
-          if ((throttle > THR_TRG_TRESHOLD) && timerState->state == TMR_OFF) {
-            timerState->state = TMR_RUNNING;  // start timer running
-            timerState->cnt = 0;
-            timerState->sum = 0;
-            TRACE("Timer[%d] THr triggered", i);
-          }
-          if (timerState->state != TMR_OFF) newTimerVal++;
+    timerState->val_10ms -= 100;
+
+    // a saturated timer must not hold the other ones
+    if (timerState->val == TIMER_MAX || timerState->val == TIMER_MIN)
+      continue;
+
+    uint16_t tv = g_model.timers[i].start;
+    int16_t newTimerVal = timerState->val;
+    if (tv) newTimerVal = tv - newTimerVal;
+
+    if (tm == TMRMODE_ABS) {
+      newTimerVal++;
+    }
+    else if (tm == TMRMODE_THR) {
+      if (throttle) newTimerVal++;
+    }
+    else if (tm == TMRMODE_THR_REL) {
+      // one second of full throttle is counted each time the throttle integral reaches its threshold,
+      // the remainder is kept for the next seconds (cnt is at least 1 here)
+      uint16_t threshold = timerState->cnt << THR_REL_SHIFT;
+      if (timerState->sum >= threshold) {
+        newTimerVal++;
+        timerState->sum -= threshold;
+      }
+      timerState->cnt = 0;
+    }
+    else if (tm == TMRMODE_THR_TRG) {
+      // we can't rely on (throttle || newTimerVal > 0) as a detection if timer should be running
+      // because having persistent timer brakes this rule
+      if ((throttle > THR_TRG_TRESHOLD) && timerState->state == TMR_OFF) {
+        timerStart(i);  // start timer running
+        TRACE("Timer[%d] THr triggered", i);
+      }
+      if (timerState->state != TMR_OFF) newTimerVal++;
+    }
+    else {
+      if (tm > 0) tm -= (TMRMODE_COUNT-1);
+      if (getSwitch(tm))
+        newTimerVal++;
+    }
+
+    switch (timerState->state) {
+      case TMR_RUNNING:
+        if (tv && newTimerVal>=(int16_t)tv) {
+          AUDIO_TIMER_00(g_model.timers[i].countdownBeep);
+          timerState->state = TMR_NEGATIVE;
+          TRACE("Timer[%d] negative", i);
         }
-        else {
-          if (tm > 0) tm -= (TMRMODE_COUNT-1);
-          if (getSwitch(tm))
-            newTimerVal++;
+        break;
+      case TMR_NEGATIVE:
+        if (newTimerVal >= (int16_t)tv + MAX_ALERT_TIME) {
+          timerState->state = TMR_STOPPED;
+          TRACE("Timer[%d] stopped state at %d", i, newTimerVal);
         }
+        break;
+    }
 
-        switch (timerState->state) {
-          case TMR_RUNNING:
-            if (tv && newTimerVal>=(int16_t)tv) {
-              AUDIO_TIMER_00(g_model.timers[i].countdownBeep);
-              timerState->state = TMR_NEGATIVE;
-              TRACE("Timer[%d] negative", i);
-            }
-            break;
-          case TMR_NEGATIVE:
-            if (newTimerVal >= (int16_t)tv + MAX_ALERT_TIME) {
-              timerState->state = TMR_STOPPED;
-              TRACE("Timer[%d] stopped state at %d", i, newTimerVal);
-            }
-            break;
-        }
+    if (tv) newTimerVal = tv - newTimerVal; // if counting backwards - display backwards
 
-        if (tv) newTimerVal = tv - newTimerVal; // if counting backwards - display backwards
-
-        if (newTimerVal != timerState->val) {
-          timerState->val = newTimerVal;
-          if (timerState->state == TMR_RUNNING) {
-            if (g_model.timers[i].countdownBeep && g_model.timers[i].start) {
-              if (newTimerVal==30) { 
-                AUDIO_TIMER_30(); 
-                TRACE("Timer[%d] 30s announcement", i); 
-              }
-              if (newTimerVal==20) { 
-                AUDIO_TIMER_20();
-                TRACE("Timer[%d] 20s announcement", i); 
-              }
-              if (newTimerVal<=10) {
-                AUDIO_TIMER_LT10(g_model.timers[i].countdownBeep, newTimerVal);
-                TRACE("Timer[%d] %ds announcement", i, newTimerVal);
-              }
-            }
-            if (g_model.timers[i].minuteBeep && (newTimerVal % 60)==0) {
-              AUDIO_TIMER_MINUTE(newTimerVal);
-              TRACE("Timer[%d] %d minute announcement", i, newTimerVal/60);
-            }
-          }
+    if (newTimerVal != timerState->val) {
+      timerState->val = newTimerVal;
+      if (timerState->state == TMR_RUNNING) {
+        int16_t announce = timerState->announce;
+        if (announce == TIMER_MIN || (tv ? newTimerVal < announce : newTimerVal > announce)) {
+          // unknown, or skipped because the timer has been changed
+          announce = timerNextAnnounce(tv, tv ? newTimerVal+1 : newTimerVal-1);
+        }
+        if (newTimerVal == announce) {
+          timerAnnounce(i, newTimerVal);
+          announce = timerNextAnnounce(tv, newTimerVal);
         }
+        timerState->announce = announce;
       }
     }
   }
@@ -51,10 +51,23 @@ struct TimerState {
   uint8_t  state;
   int16_t  val;
   uint8_t  val_10ms;
+  int16_t  announce;  // next value at which something may be announced, TIMER_MIN when unknown
 };
 
 extern TimerState timersStates[TIMERS];
 
+#if defined(SIMU)
+enum TimerAnnounces {
+  TIMER_ANNOUNCE_MINUTE,
+  TIMER_ANNOUNCE_30,
+  TIMER_ANNOUNCE_20,
+  TIMER_ANNOUNCE_LT10,
+  TIMER_ANNOUNCE_COUNT
+};
+
+extern uint16_t timersAnnounces[TIMERS][TIMER_ANNOUNCE_COUNT]; // announcements played, checked by the tests
+#endif
+
 void timerReset(uint8_t idx);
 
 #if defined(CPUARM)
@@ -48,8 +48,7 @@ void varioWakeup()
 #if defined(CPUARM)
     int verticalSpeed = 0;
     if (g_model.frsky.varioSource) {
-      TelemetryItem & varioItem = telemetryItems[g_model.frsky.varioSource-1];
-      verticalSpeed = varioItem.value;
+      verticalSpeed = getTelemetrySnapshotValue(g_model.frsky.varioSource-1).value;
       TelemetrySensor & sensor = g_model.telemetrySensors[g_model.frsky.varioSource-1];
       if (sensor.prec != 2) verticalSpeed *= sensor.prec == 0 ? 100 : 10;
     }